@@ -9,6 +9,7 @@
 #define INC_TASKS_H_
 
 #include "main.h"
+#include "scheduler.h"
 
 #define TIMER_TICK_MS 10
 
@@ -18,5 +19,7 @@ void Task_LED3(void);
 void Task_LED4(void);
 void Task_LED5(void);
 
+void Tasks_Register(SCH_Context* ctx);
+
 
 #endif /* INC_TASKS_H_ */
@@ -0,0 +1,43 @@
+#ifndef __ADC_STREAM_H
+#define __ADC_STREAM_H
+
+#include "main.h"
+#include "scheduler.h"
+
+/*----------------------------------------------------------------------------
+ * ADC Streaming (ADC1 + DMA1 Channel 1, paced by TIM1)
+ *
+ * TIM1 compare 1 starts a conversion of the channel sequence at an exact
+ * rate. DMA writes the results into a circular buffer of two halves of
+ * ADC_STREAM_FRAMES sequences each. The half- and full-transfer
+ * interrupts only set an event flag; a flag task then hands the completed
+ * half to the processing function while DMA fills the other half. The
+ * CPU never touches single samples, and sampling jitter is that of the
+ * timer, not of the dispatcher.
+ *
+ * A block is interleaved: block[frame * channels + i] is channel i.
+ * Processing must finish within one half (ADC_STREAM_FRAMES / rate);
+ * otherwise the half is being overwritten and Overruns counts it.
+ *
+ * Conversion time is (55.5 + 12.5) / 4 MHz = 17 us per channel, so the
+ * sequence rate must stay below 1 / (17 us x channels). TIM1 counts at
+ * 1 MHz into a 16-bit period, so the rate must also be at least 16 Hz.
+ * ADC_Stream_Init rejects rates outside ADC_STREAM_MIN_HZ ..
+ * 1000000 / (ADC_STREAM_CONV_US x channels).
+ *
+ * Registers are programmed directly; the HAL ADC driver is not needed.
+ *---------------------------------------------------------------------------*/
+
+#define ADC_STREAM_FRAMES           32      // Sequences per half buffer
+#define ADC_STREAM_MAX_CHANNELS     4
+#define ADC_STREAM_MIN_HZ           16      // 1 MHz / 16 fits the 16-bit ARR
+#define ADC_STREAM_CONV_US          17      // Per channel, sample + conversion
+
+typedef void (*ADC_Stream_Process)(const uint16_t* block, uint16_t frames, uint8_t channels);
+
+uint8_t ADC_Stream_Init(SCH_Context* ctx, const uint8_t* channels, uint8_t count, uint32_t rateHz,
+                        ADC_Stream_Process process);
+uint32_t ADC_Stream_Get_Overruns(void);
+void ADC_Stream_DMA_IRQHandler(void);
+
+#endif // __ADC_STREAM_H
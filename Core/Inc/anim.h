@@ -0,0 +1,81 @@
+#ifndef __ANIM_H
+#define __ANIM_H
+
+#include <stdint.h>
+#include "scheduler.h"
+
+/*----------------------------------------------------------------------------
+ * LED Animation - keyframe patterns played from delta timelines
+ *
+ * A pattern is a list of keyframes (time, level). A level either holds
+ * until the next keyframe or, if that keyframe is marked as a fade, ramps
+ * to it linearly. ANIM_Compile() turns the keyframes into a timeline of
+ * (ticks since previous step, level) steps, with fades quantized to
+ * ANIM_FADE_QUANTUM levels so a ramp is a handful of steps, not one per
+ * tick. Timelines can be compiled once at registration into RAM, or at
+ * build time into const arrays in flash (Host/Tools/anim_compile.c).
+ *
+ * A player drives all animated LEDs of one port from a single one-shot
+ * task that is re-armed for the earliest next step, so the CPU only wakes
+ * when some LED actually changes. Levels are written through a callback
+ * (LED_BAM_Set, a PWM or plain GPIO adapter), so the engine itself does
+ * not touch hardware.
+ *
+ * Example: blink code "two short, pause" on LED4 (BAM):
+ *   static const ANIM_Keyframe code2[] = {
+ *       { 0, 255, 0 }, { 150, 0, 0 }, { 300, 255, 0 }, { 450, 0, 0 },
+ *   };
+ *   static ANIM_Step code2Steps[8];
+ *   static ANIM_Timeline code2Line;
+ *   ANIM_Compile(code2, 4, 1500, TIMER_TICK_MS, code2Steps, 8, &code2Line);
+ *   ANIM_Player_Init(&portA, ctx);
+ *   ANIM_Play(&portA, LED4_Pin, LED_BAM_Set, &code2Line);
+ *---------------------------------------------------------------------------*/
+
+#define ANIM_MAX_CHANNELS       8       // Animated LEDs per player
+#define ANIM_FADE_QUANTUM       16      // Level change per fade step
+
+typedef struct {
+    uint16_t TimeMs;                    // From pattern start
+    uint8_t Level;
+    uint8_t Fade;                       // 1: ramp from the previous keyframe
+} ANIM_Keyframe;
+
+typedef struct {
+    uint16_t Delta;                     // Ticks since the previous step
+    uint8_t Level;
+} ANIM_Step;
+
+typedef struct {
+    const ANIM_Step* Steps;
+    uint16_t Count;
+    uint16_t LoopTicks;                 // Pattern length when looping, 0 = play once
+} ANIM_Timeline;
+
+typedef void (*ANIM_Write)(uint16_t id, uint8_t level);
+
+typedef struct {
+    ANIM_Write Write;
+    uint16_t Id;                        // Passed to Write (pin, channel...)
+    const ANIM_Timeline* Timeline;
+    uint16_t Index;                     // Next step
+    uint32_t Start;                     // Tick the current pass began
+    uint32_t Due;                       // Tick of the next step
+} ANIM_Channel;
+
+typedef struct {
+    SCH_Context* Ctx;
+    ANIM_Channel Channels[ANIM_MAX_CHANNELS];
+    uint8_t Count;
+    uint32_t TaskID;                    // Pending wakeup, NO_TASK_ID if none
+    uint32_t WakeAt;
+    uint32_t Wakeups;
+} ANIM_Player;
+
+uint16_t ANIM_Compile(const ANIM_Keyframe* frames, uint16_t count, uint16_t loopMs, uint16_t tickMs,
+                      ANIM_Step* steps, uint16_t maxSteps, ANIM_Timeline* timeline);
+void ANIM_Player_Init(ANIM_Player* player, SCH_Context* ctx);
+uint8_t ANIM_Play(ANIM_Player* player, uint16_t id, ANIM_Write write, const ANIM_Timeline* timeline);
+uint8_t ANIM_Stop(ANIM_Player* player, uint16_t id);
+
+#endif // __ANIM_H
@@ -0,0 +1,50 @@
+#ifndef __CAPTURE_H
+#define __CAPTURE_H
+
+#include "main.h"
+#include "scheduler.h"
+
+/*----------------------------------------------------------------------------
+ * Input Capture Timestamping (TIM2 CH1 on PA0)
+ *
+ * TIM2 is the tick timer, so its counter already measures time inside
+ * the current tick. The hardware latches the counter on each edge of PA0;
+ * the capture interrupt extends that value with the scheduler's tick
+ * count to a 64-bit time in counter steps:
+ *
+ *   time = ticks * (ARR + 1) + CCR1
+ *
+ * (one tick more if the capture came after an overflow whose update
+ * interrupt is still pending). Events go into a ring buffer and a flag
+ * task hands them to the handler once CAP_Init's 'batch' events are
+ * waiting, so tasks never poll the pin. 'timeoutTicks' bounds how long a
+ * partial batch can wait: the task also runs that many ticks after its
+ * previous run, edges or not, and returns at once if the ring is empty.
+ * A partial batch is therefore flushed within 'timeoutTicks' of its first
+ * event, not exactly that long after it.
+ *
+ * With countHz = 1000000 the timer is re-timed to 1 us steps while the
+ * tick stays at 10 ms; pass 0 to keep the current timebase (e.g. the
+ * 10 us steps of the PWM LED driver).
+ *---------------------------------------------------------------------------*/
+
+#define CAP_RING_SIZE           32      // Events buffered between batches
+
+#define CAP_EDGE_RISING         0x01
+#define CAP_EDGE_FALLING        0x02
+#define CAP_EDGE_BOTH           (CAP_EDGE_RISING | CAP_EDGE_FALLING)
+
+typedef struct {
+    uint64_t Time;                      // Counter steps since the scheduler started
+    uint8_t Rising;                     // 1 = rising edge, 0 = falling edge
+} CAP_Event;
+
+typedef void (*CAP_Handler)(const CAP_Event* events, uint16_t count);
+
+uint8_t CAP_Init(SCH_Context* ctx, TIM_HandleTypeDef* htim, uint32_t countHz, uint8_t edges, uint16_t batch,
+                 uint32_t timeoutTicks, CAP_Handler handler);
+uint32_t CAP_Get_Count_Hz(void);
+uint32_t CAP_Get_Dropped(void);
+void CAP_Capture_IRQHandler(void);
+
+#endif // __CAPTURE_H
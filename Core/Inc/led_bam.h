@@ -0,0 +1,31 @@
+#ifndef __LED_BAM_H
+#define __LED_BAM_H
+
+#include "main.h"
+
+/*----------------------------------------------------------------------------
+ * Bit-Angle Modulation LED Driver (TIM3 interrupt, any GPIO pins)
+ *
+ * Dims LEDs on pins without a timer channel (LED4/LED5 on PA4/PA5).
+ * A level of LED_BAM_BITS bits is shown one bit plane at a time: plane k
+ * lasts 2^k time units, and entering it is a single BSRR write that sets
+ * or clears all driven pins of the port at once. A frame therefore costs
+ * LED_BAM_BITS interrupts whatever the number of pins or levels, where
+ * software PWM would need one per level step.
+ *
+ * TIM3 counts at 1 MHz; with 8 bits and a 32 us unit a frame is 8.16 ms
+ * (~122 Hz). New levels are prepared in a second plane buffer and take
+ * effect at the next frame start, so a frame is never torn.
+ *---------------------------------------------------------------------------*/
+
+#define LED_BAM_BITS            8       // Levels 0..255
+#define LED_BAM_UNIT_US         32      // Length of the shortest bit plane
+#define LED_BAM_MAX             ((1u << LED_BAM_BITS) - 1u)
+
+void LED_BAM_Init(GPIO_TypeDef* port, uint16_t pins);
+void LED_BAM_Set(uint16_t pin, uint8_t level);
+uint8_t LED_BAM_Get(uint16_t pin);
+void LED_BAM_Toggle(uint16_t pin);
+void LED_BAM_IRQHandler(void);
+
+#endif // __LED_BAM_H
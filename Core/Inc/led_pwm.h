@@ -0,0 +1,31 @@
+#ifndef __LED_PWM_H
+#define __LED_PWM_H
+
+#include "main.h"
+
+/*----------------------------------------------------------------------------
+ * Hardware PWM LED Driver (TIM2 CH2..CH4 on PA1..PA3)
+ *
+ * LED1..LED3 are the TIM2_CH2..CH4 alternate functions of their pins.
+ * In PWM mode (LED_DRIVER_PWM defined in the build) the pins are handed
+ * to the timer and brightness is a compare value, so dimming needs no CPU
+ * at all and a blink is one compare register write.
+ *
+ * TIM2 also produces the scheduler tick, so the tick period is kept:
+ * the counter runs at 100 kHz and wraps every LED_PWM_STEPS counts
+ * (10 ms), giving 100 Hz PWM with 0.1% steps. The compare registers are
+ * preloaded, so a new value takes effect at the next update event, i.e.
+ * exactly on a tick boundary no matter when the task writing it was
+ * dispatched.
+ *---------------------------------------------------------------------------*/
+
+#define LED_PWM_COUNT           3       // LED1..LED3
+#define LED_PWM_STEPS           1000    // Brightness range 0..LED_PWM_STEPS
+
+void LED_PWM_Init(TIM_HandleTypeDef* htim);
+void LED_PWM_Set(uint8_t led, uint16_t level);
+uint16_t LED_PWM_Get(uint8_t led);
+void LED_PWM_Set_On_Level(uint8_t led, uint16_t level);
+void LED_PWM_Toggle(uint8_t led);
+
+#endif // __LED_PWM_H
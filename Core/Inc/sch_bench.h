@@ -0,0 +1,32 @@
+#ifndef __SCH_BENCH_H
+#define __SCH_BENCH_H
+
+#include <stdint.h>
+
+/*----------------------------------------------------------------------------
+ * Scheduler Microbenchmark (on-target)
+ *
+ * Only compiled into the "Benchmark" build configuration (SCH_BENCHMARK
+ * defined). main() calls SCH_Bench_Run() before any peripheral is set up;
+ * it measures add/delete/update/dispatch in CPU cycles for several task
+ * counts, prints a machine-readable report through semihosting and exits
+ * the debug session. Runs on hardware (DWT cycle counter) and under QEMU
+ * (SysTick fallback, DWT is not emulated). The configuration links with
+ * STM32F103C6UX_BENCH.ld, which limits RAM to the 8 KB of the emulated
+ * STM32F100:
+ *
+ *   qemu-system-arm -M stm32vldiscovery -nographic -icount shift=0 \
+ *       -semihosting-config enable=on,target=native -kernel LAB4.1.elf
+ *
+ * Report format, one record per line:
+ *   SCHBENCH 1 counter=<dwt|systick>
+ *   <op> n=<tasks> reps=<count> min=<cycles> avg=<cycles> max=<cycles>
+ *   SCHBENCH END
+ *---------------------------------------------------------------------------*/
+
+#define SCH_BENCH_REPS          64  // Timed samples per op and task count
+#define SCH_BENCH_MAX_TASKS     64  // Largest task count (nodes fit in 8 KB RAM)
+
+void SCH_Bench_Run(void);
+
+#endif // __SCH_BENCH_H
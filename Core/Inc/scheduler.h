@@ -7,17 +7,293 @@
 #define ERROR_SCH_TOO_MANY_TASKS            1
 #define ERROR_SCH_CANNOT_DELETE_TASK        2
 #define ERROR_SCH_TASK_NOT_FOUND            3
+#define ERROR_SCH_DEPENDENCY_CYCLE          4
 #define NO_TASK_ID                          0
 
-/* Core scheduler functions */
+/* Task criticality, used by load shedding (SCH_Ctx_Set_Overload_Policy) */
+#define SCH_CRIT_LOW                        0
+#define SCH_CRIT_MEDIUM                     1
+#define SCH_CRIT_HIGH                       2   // Default for new tasks
+
+/* Elastic period scale, fixed point (SCH_ELASTIC_ONE = 1.0) */
+#define SCH_ELASTIC_SHIFT                   8
+#define SCH_ELASTIC_ONE                     (1u << SCH_ELASTIC_SHIFT)
+#define SCH_ELASTIC_MAX                     (64u << SCH_ELASTIC_SHIFT)
+
+/* Event flag task options (SCH_Ctx_Add_Flag_Task) */
+#define SCH_FLAGS_ANY                       0x00    // Released by any flag of the mask
+#define SCH_FLAGS_ALL                       0x01    // Released when all flags of the mask are set
+#define SCH_FLAGS_CLEAR                     0x02    // Clear the flags that released the task
+
+/* Returned by SCH_Ctx_Get_Ticks_To_Next() when no task is scheduled */
+#define SCH_NO_DEADLINE                     0xFFFFFFFFu
+
+/*----------------------------------------------------------------------------
+ * Scheduler Context - all state of one scheduler instance
+ *
+ * Every SCH_Ctx_* function operates on the context it is given, so several
+ * independent schedulers (one per tick domain on target, or thousands in a
+ * host simulation) can coexist. The plain SCH_* API below works on a single
+ * built-in default context and behaves exactly as before.
+ *---------------------------------------------------------------------------*/
+struct TaskNode;
+
+/* Operating mode: a task set prepared ahead of time (see SCH_Mode_Init) */
+typedef struct SCH_Mode {
+    struct TaskNode* TaskListHead;  // Sorted list of the mode's own tasks
+    const char* Name;
+} SCH_Mode;
+
+/* Aperiodic job queued on a server (see SCH_Server_Init) */
+typedef struct {
+    void (*Job)(void*);
+    void* Arg;
+    uint32_t PostTick;              // Tick the job was posted
+} SCH_Job;
+
+typedef struct SCH_Server {
+    SCH_Job* Queue;                 // Ring buffer supplied by the caller
+    uint16_t Capacity;
+    volatile uint16_t Head;         // Next job to run (dispatcher)
+    volatile uint16_t Tail;         // Next free entry (producer)
+    uint32_t Budget;                // Per period: cycles, or jobs without a counter
+    uint32_t Period;                // Replenishment period in ticks
+    int32_t Remaining;              // Budget left in this period (< 0: overrun)
+    uint32_t PeriodStart;
+    uint32_t Served;
+    uint32_t Dropped;               // Posts lost to a full queue
+    uint32_t MaxWait;               // Longest post-to-run time seen (ticks)
+    struct SCH_Context* Ctx;
+    struct SCH_Server* next;
+} SCH_Server;
+
+/* Task group sharing a CPU budget per major frame */
+typedef struct SCH_Partition {
+    const char* Name;
+    uint32_t Budget;                // Per frame: cycles, or runs without a counter
+    uint32_t Used;                  // Spent in the current frame
+    uint32_t Denied;                // Releases held back for lack of budget
+    uint32_t Overruns;              // Frames that ended above budget
+    struct SCH_Partition* next;
+} SCH_Partition;
+
+/* Subscriber of a topic: message in its slot and its sequence number */
+typedef void (*SCH_Subscriber)(const void* msg, uint32_t seq);
+
+typedef struct SCH_Topic {
+    const char* Name;
+    void* Slots;                    // Depth message slots of SlotSize bytes
+    uint16_t SlotSize;
+    uint16_t Depth;
+    const SCH_Subscriber* Subscribers;
+    uint16_t NumSubscribers;
+    volatile uint32_t Seq;          // Last published sequence number
+    uint32_t Delivered;             // Last sequence number delivered
+    uint32_t Lost;                  // Messages overwritten before delivery
+    struct SCH_Topic* next;
+} SCH_Topic;
+
+/*
+ * Define a topic with 'depth' (>= 2) slots of 'type' and a const
+ * subscriber table, all statically allocated. Up to depth - 1 messages
+ * wait for delivery. Register it with SCH_Ctx_Add_Topic().
+ */
+#define SCH_TOPIC_DEFINE(name, type, depth, subscribers)                    \
+    static type name##_Slots[depth];                                        \
+    SCH_Topic name = {                                                      \
+        .Name = #name,                                                      \
+        .Slots = name##_Slots,                                              \
+        .SlotSize = sizeof(type),                                           \
+        .Depth = (depth),                                                   \
+        .Subscribers = (subscribers),                                       \
+        .NumSubscribers = sizeof(subscribers) / sizeof((subscribers)[0]),   \
+    }
+
+/* Fixed-size buffer pool (see SCH_Pool_Init) */
+typedef struct {
+    void** FreeRing;                // Free blocks, Count + 1 entries
+    uint16_t Capacity;
+    uint16_t BlockSize;
+    volatile uint16_t Head;         // Next block to hand out
+    volatile uint16_t Tail;         // Next entry for a released block
+    uint16_t MinFree;               // Low-water mark of free blocks
+} SCH_Pool;
+
+typedef struct SCH_Mailbox {
+    void** Queue;                   // Posted buffers, ring supplied by the caller
+    uint16_t Capacity;
+    volatile uint16_t Head;         // Next message to consume (dispatcher)
+    volatile uint16_t Tail;         // Next free entry (producer)
+    SCH_Pool* Pool;                 // Buffers go back here after consumption
+    void (*Consumer)(void* msg);
+    uint32_t Received;
+    uint32_t Dropped;               // Posts refused by a full mailbox
+    struct SCH_Mailbox* next;
+} SCH_Mailbox;
+
+/* Group of 32 event flags (see SCH_Flags_Init) */
+typedef struct SCH_Flags {
+    volatile uint32_t Bits;
+    struct TaskNode* Waiters;       // Flag tasks of this group
+    struct SCH_Flags* next;
+} SCH_Flags;
+
+typedef struct SCH_Context {
+    struct TaskNode* TaskListHead;  // Head of sorted task list
+    uint32_t CurrentTick;           // System tick counter (10ms each)
+    uint32_t NextTaskID;            // Auto-increment task ID
+    uint8_t ErrorCode;              // Error code register
+    uint32_t WakeupsSaved;          // Slack releases merged into other wakeups
+    SCH_Mode* ActiveMode;           // Mode whose tasks run besides the list above
+    SCH_Mode* PendingMode;          // Applied at the next tick
+    uint8_t SwitchPending;
+
+    /* Load shedding (off while ShedBelow == 0) */
+    uint32_t OverloadTicks;         // Late ticks in a row that mean overload
+    uint32_t OverloadBacklog;       // Due tasks at dispatch that mean overload
+    uint32_t RecoverTicks;          // On-time ticks in a row to recover
+    uint8_t ShedBelow;              // Shed tasks with lower criticality
+    uint8_t Overloaded;
+    uint32_t LateTicks;             // Ticks the due head has been waiting
+    uint32_t OnTimeTicks;
+    uint32_t ShedCount;             // Periodic releases skipped
+    uint32_t DeferCount;            // One-shot releases deferred (per tick)
+    uint32_t OverloadEpisodes;
+    uint8_t Dispatching;            // Released tasks being run right now
+
+    /* Execution time measurement and elastic periods */
+    uint32_t (*ReadCycles)(void);   // Free-running cycle counter, or NULL
+    uint32_t CyclesPerTick;
+    uint32_t BusyCycles;            // Task cycles in the current window
+    uint32_t WindowStart;           // Tick the window began
+    uint32_t WindowTicks;
+    uint32_t TargetUtilization;     // Per mille, 0 = elastic control off
+    uint32_t Utilization;           // Per mille, last window
+    uint32_t ElasticScale;          // Applied to elastic periods
+
+    SCH_Server* Servers;            // Aperiodic servers, run after due tasks
+
+    SCH_Partition* Partitions;
+    uint32_t FrameTicks;            // Major frame length, 0 = no budgets
+    uint32_t FrameStart;            // Tick the current frame began
+
+    struct TaskNode* ParkedTasks;   // Triggered tasks waiting for predecessors
+
+    SCH_Topic* Topics;              // Delivered after the due tasks
+    SCH_Mailbox* Mailboxes;         // Consumed after the topics
+
+    SCH_Flags* FlagGroups;
+    uint32_t WakeFlags;             // Flags that released the running task
+    uint32_t DispatchPass;          // Dispatch calls so far (flag releases)
+    uint32_t VisitMark;             // Last mark of the dependency cycle check
+} SCH_Context;
+
+/* Context-based scheduler functions */
+void SCH_Ctx_Init(SCH_Context* ctx);
+void SCH_Ctx_Deinit(SCH_Context* ctx);
+void SCH_Ctx_Update(SCH_Context* ctx);
+void SCH_Ctx_Dispatch_Tasks(SCH_Context* ctx);
+uint32_t SCH_Ctx_Add_Task(SCH_Context* ctx, void (*pFunction)(void), uint32_t DELAY, uint32_t PERIOD);
+uint32_t SCH_Ctx_Add_Task_Arg(SCH_Context* ctx, void (*pFunction)(void*), void* arg, uint32_t DELAY, uint32_t PERIOD);
+uint32_t SCH_Ctx_Add_Task_Slack(SCH_Context* ctx, void (*pFunction)(void), uint32_t DELAY, uint32_t PERIOD,
+                                uint32_t SLACK);
+uint8_t SCH_Ctx_Delete_Task(SCH_Context* ctx, uint32_t taskID);
+uint32_t SCH_Ctx_Get_Current_Time(SCH_Context* ctx);
+uint8_t SCH_Ctx_Get_Error_Code(SCH_Context* ctx);
+uint32_t SCH_Ctx_Get_Current_Tick(SCH_Context* ctx);
+uint32_t SCH_Ctx_Get_Wakeups_Saved(SCH_Context* ctx);
+
+/* Batched time advance (host simulation, tickless operation) */
+void SCH_Ctx_Advance(SCH_Context* ctx, uint32_t ticks);
+uint32_t SCH_Ctx_Get_Ticks_To_Next(SCH_Context* ctx);
+
+/* Operating modes */
+void SCH_Mode_Init(SCH_Mode* mode, const char* name);
+void SCH_Mode_Clear(SCH_Context* ctx, SCH_Mode* mode);
+uint32_t SCH_Mode_Add_Task(SCH_Context* ctx, SCH_Mode* mode, void (*pFunction)(void), uint32_t DELAY,
+                           uint32_t PERIOD);
+uint8_t SCH_Mode_Delete_Task(SCH_Context* ctx, SCH_Mode* mode, uint32_t taskID);
+void SCH_Ctx_Switch_Mode(SCH_Context* ctx, SCH_Mode* mode);
+SCH_Mode* SCH_Ctx_Get_Mode(SCH_Context* ctx);
+
+/* Criticality-aware load shedding */
+void SCH_Ctx_Set_Overload_Policy(SCH_Context* ctx, uint32_t lateTicks, uint32_t backlog, uint32_t recoverTicks,
+                                 uint8_t shedBelow);
+uint8_t SCH_Ctx_Set_Criticality(SCH_Context* ctx, uint32_t taskID, uint8_t level);
+uint8_t SCH_Ctx_Is_Overloaded(SCH_Context* ctx);
+uint32_t SCH_Ctx_Get_Shed_Count(SCH_Context* ctx);
+
+/* Execution time measurement and elastic periods */
+void SCH_Ctx_Set_Cycle_Counter(SCH_Context* ctx, uint32_t (*read)(void), uint32_t cyclesPerTick);
+uint8_t SCH_Ctx_Set_Elastic(SCH_Context* ctx, uint32_t taskID, uint32_t minPeriod, uint32_t maxPeriod);
+void SCH_Ctx_Set_Utilization_Target(SCH_Context* ctx, uint32_t permille, uint32_t windowTicks);
+uint32_t SCH_Ctx_Get_Utilization(SCH_Context* ctx);
+uint32_t SCH_Ctx_Get_Task_Period(SCH_Context* ctx, uint32_t taskID);
+
+/* Aperiodic servers */
+void SCH_Server_Init(SCH_Server* srv, SCH_Job* queue, uint16_t capacity, uint32_t budget, uint32_t period);
+void SCH_Ctx_Add_Server(SCH_Context* ctx, SCH_Server* srv);
+uint8_t SCH_Server_Post(SCH_Server* srv, void (*job)(void*), void* arg);
+
+/* Partitions */
+void SCH_Partition_Init(SCH_Partition* part, const char* name, uint32_t budget);
+void SCH_Ctx_Add_Partition(SCH_Context* ctx, SCH_Partition* part);
+void SCH_Ctx_Set_Major_Frame(SCH_Context* ctx, uint32_t ticks);
+uint8_t SCH_Ctx_Set_Partition(SCH_Context* ctx, uint32_t taskID, SCH_Partition* part);
+
+/* Task chains */
+uint32_t SCH_Ctx_Add_Triggered_Task(SCH_Context* ctx, void (*pFunction)(void));
+uint8_t SCH_Ctx_Add_Dependency(SCH_Context* ctx, uint32_t beforeID, uint32_t afterID);
+
+/* Topics */
+void SCH_Ctx_Add_Topic(SCH_Context* ctx, SCH_Topic* topic);
+void* SCH_Topic_Claim(SCH_Topic* topic);
+uint32_t SCH_Topic_Publish(SCH_Topic* topic);
+const void* SCH_Topic_Latest(SCH_Topic* topic, uint32_t* seq);
+
+/* Buffer pools and mailboxes */
+void SCH_Pool_Init(SCH_Pool* pool, void* storage, uint16_t blockSize, uint16_t count, void** freeRing);
+void* SCH_Pool_Acquire(SCH_Pool* pool);
+void SCH_Pool_Release(SCH_Pool* pool, void* block);
+uint16_t SCH_Pool_Available(SCH_Pool* pool);
+void SCH_Mailbox_Init(SCH_Mailbox* mbox, void** queue, uint16_t capacity, SCH_Pool* pool,
+                      void (*consumer)(void* msg));
+void SCH_Ctx_Add_Mailbox(SCH_Context* ctx, SCH_Mailbox* mbox);
+uint8_t SCH_Mailbox_Post(SCH_Mailbox* mbox, void* msg);
+
+/* Event flags */
+void SCH_Flags_Init(SCH_Flags* group);
+void SCH_Ctx_Add_Flags(SCH_Context* ctx, SCH_Flags* group);
+uint32_t SCH_Flags_Set(SCH_Flags* group, uint32_t mask);
+uint32_t SCH_Flags_Clear(SCH_Flags* group, uint32_t mask);
+uint32_t SCH_Flags_Get(SCH_Flags* group);
+uint32_t SCH_Ctx_Add_Flag_Task(SCH_Context* ctx, void (*pFunction)(void), SCH_Flags* group, uint32_t mask,
+                               uint8_t options, uint32_t timeout);
+uint32_t SCH_Ctx_Get_Wake_Flags(SCH_Context* ctx);
+
+/* Core scheduler functions (default context) */
 void SCH_Init(void);
 void SCH_Update(void);
 void SCH_Dispatch_Tasks(void);
 uint32_t SCH_Add_Task(void (*pFunction)(void), uint32_t DELAY, uint32_t PERIOD);
+uint32_t SCH_Add_Task_Slack(void (*pFunction)(void), uint32_t DELAY, uint32_t PERIOD, uint32_t SLACK);
+void SCH_Switch_Mode(SCH_Mode* mode);
+uint8_t SCH_Set_Criticality(uint32_t taskID, uint8_t level);
+void SCH_Add_Server(SCH_Server* srv);
+uint8_t SCH_Set_Partition(uint32_t taskID, SCH_Partition* part);
+void SCH_Add_Topic(SCH_Topic* topic);
+void SCH_Add_Mailbox(SCH_Mailbox* mbox);
+void SCH_Add_Flags(SCH_Flags* group);
+uint32_t SCH_Add_Flag_Task(void (*pFunction)(void), SCH_Flags* group, uint32_t mask, uint8_t options,
+                           uint32_t timeout);
+uint32_t SCH_Get_Wake_Flags(void);
+uint32_t SCH_Add_Triggered_Task(void (*pFunction)(void));
+uint8_t SCH_Add_Dependency(uint32_t beforeID, uint32_t afterID);
 uint8_t SCH_Delete_Task(uint32_t taskID);
 
-/* Utility functions */
+/* Utility functions (default context) */
 uint32_t SCH_Get_Current_Time(void);
 uint8_t SCH_Get_Error_Code(void);
+SCH_Context* SCH_Get_Default_Context(void);
 
 #endif // __SCHEDULER_H
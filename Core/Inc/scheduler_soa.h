@@ -0,0 +1,73 @@
+#ifndef __SCHEDULER_SOA_H
+#define __SCHEDULER_SOA_H
+
+#include <stdint.h>
+#include "scheduler.h"
+
+/*----------------------------------------------------------------------------
+ * Structure-of-Arrays Scheduler Backend
+ *
+ * Alternative to the delta list in scheduler.c for large timer counts
+ * (host simulation, bigger targets). Deadlines are kept in one packed
+ * array apart from callbacks and metadata, so finding due tasks is a
+ * straight compare over contiguous memory (AVX2/SSE2 on the host, an
+ * unrolled loop on Cortex-M). Add and delete are O(1).
+ *
+ * Dispatch order and times are identical to scheduler.c, including its
+ * rule that time stands still for waiting tasks while a due task has not
+ * been dispatched yet.
+ *
+ * All memory is supplied by the caller:
+ *   static uint32_t mem[SCH_SOA_MEM_WORDS(64)];
+ *   SCH_SoA_Init(&soa, mem, 64);
+ *---------------------------------------------------------------------------*/
+
+#define SCH_SOA_SLOT_BITS       20  // Up to 1M tasks per instance
+#define SCH_SOA_MAX_TASKS       ((1u << SCH_SOA_SLOT_BITS) - 1)
+
+/* Words of storage needed for 'cap' tasks (64-byte aligned arrays) */
+#define SCH_SOA_ROUND(cap)      (((cap) + 15u) & ~15u)
+#define SCH_SOA_MEM_WORDS(cap)  (SCH_SOA_ROUND(cap) * (9u + 3u * (uint32_t)(sizeof(void*) / 4u)) + 16u)
+
+typedef struct {
+    /* Hot: scanned on every due tick */
+    uint32_t* Deadline;             // Virtual-time deadline per packed task
+    uint32_t Count;                 // Packed tasks in use
+    uint32_t Now;                   // Virtual time (stops while a task is due)
+    uint32_t NextDue;               // Earliest deadline (valid if Count > 0)
+    uint32_t Pending;               // Due tasks of current batch not yet run
+
+    /* Cold: touched only for tasks that run */
+    uint32_t* Period;
+    uint32_t* Seq;                  // Insertion order, breaks deadline ties
+    uint32_t* TaskID;
+    void (**pTask)(void);
+    void (**pTaskArg)(void*);
+    void** Arg;
+
+    /* Task ID -> packed index */
+    uint32_t* Index;                // Per slot; SCH_SOA_FREE when unused
+    uint32_t* Generation;           // Per slot; makes stale IDs invalid
+    uint32_t* FreeSlots;            // Stack of unused slots
+    uint32_t NumFree;
+
+    uint32_t* Ready;                // Scratch: due task IDs (2 words each)
+    uint32_t Running;               // ID of the task being executed
+    uint32_t Capacity;
+    uint32_t CurrentTick;
+    uint32_t NextSeq;
+    uint8_t ErrorCode;
+} SCH_SoA_Context;
+
+void SCH_SoA_Init(SCH_SoA_Context* ctx, uint32_t* mem, uint32_t capacity);
+void SCH_SoA_Update(SCH_SoA_Context* ctx);
+void SCH_SoA_Advance(SCH_SoA_Context* ctx, uint32_t ticks);
+void SCH_SoA_Dispatch_Tasks(SCH_SoA_Context* ctx);
+uint32_t SCH_SoA_Add_Task(SCH_SoA_Context* ctx, void (*pFunction)(void), uint32_t DELAY, uint32_t PERIOD);
+uint32_t SCH_SoA_Add_Task_Arg(SCH_SoA_Context* ctx, void (*pFunction)(void*), void* arg, uint32_t DELAY, uint32_t PERIOD);
+uint8_t SCH_SoA_Delete_Task(SCH_SoA_Context* ctx, uint32_t taskID);
+uint32_t SCH_SoA_Get_Ticks_To_Next(SCH_SoA_Context* ctx);
+uint32_t SCH_SoA_Get_Current_Tick(SCH_SoA_Context* ctx);
+uint8_t SCH_SoA_Get_Error_Code(SCH_SoA_Context* ctx);
+
+#endif // __SCHEDULER_SOA_H
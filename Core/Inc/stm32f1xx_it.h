@@ -58,6 +58,8 @@ void PendSV_Handler(void);
 void SysTick_Handler(void);
 void TIM2_IRQHandler(void);
 /* USER CODE BEGIN EFP */
+void TIM3_IRQHandler(void);
+void DMA1_Channel1_IRQHandler(void);
 
 /* USER CODE END EFP */
 
@@ -5,26 +5,71 @@
  *      Author: my pc
  */
 #include "Tasks.h"
+#ifdef LED_DRIVER_PWM
+#include "led_pwm.h"
+#endif
+#ifdef LED_DRIVER_BAM
+#include "led_bam.h"
+#endif
 
 
 void Task_LED1(void) {
+#ifdef LED_DRIVER_PWM
+    LED_PWM_Toggle(0);           // Compare write, applied at the next tick
+#else
     HAL_GPIO_TogglePin(LED1_GPIO_Port, LED1_Pin);
+#endif
 }
 
 void Task_LED2(void) {
+#ifdef LED_DRIVER_PWM
+    LED_PWM_Toggle(1);           // Compare write, applied at the next tick
+#else
     HAL_GPIO_TogglePin(LED2_GPIO_Port, LED2_Pin);
+#endif
 }
 
 void Task_LED3(void) {
+#ifdef LED_DRIVER_PWM
+    LED_PWM_Toggle(2);           // Compare write, applied at the next tick
+#else
     HAL_GPIO_TogglePin(LED3_GPIO_Port, LED3_Pin);
+#endif
 }
 
 void Task_LED4(void) {
+#ifdef LED_DRIVER_BAM
+    LED_BAM_Toggle(LED4_Pin);         // Shown from the next BAM frame
+#else
     HAL_GPIO_TogglePin(LED4_GPIO_Port, LED4_Pin);
+#endif
 }
 
 void Task_LED5(void) {
+#ifdef LED_DRIVER_BAM
+    LED_BAM_Toggle(LED5_Pin);         // Shown from the next BAM frame
+#else
     HAL_GPIO_TogglePin(LED5_GPIO_Port, LED5_Pin);
+#endif
 }
 
+/*
+ * Register the application task set on a scheduler context.
+ * Shared by main() and the host simulation so both run the same tasks.
+ */
+void Tasks_Register(SCH_Context* ctx) {
+    // TASKS 1: 0.5s = 500ms = 50 ticks
+    SCH_Ctx_Add_Task(ctx, Task_LED1, 0, 500 / TIMER_TICK_MS);
+
+    // TASKS 2: 1s = 1000ms = 100 ticks
+    SCH_Ctx_Add_Task(ctx, Task_LED2, 0, 1000 / TIMER_TICK_MS);
 
+    // TASKS 3: 1.5s = 1500ms = 150 ticks
+    SCH_Ctx_Add_Task(ctx, Task_LED3, 0, 1500 / TIMER_TICK_MS);
+
+    // TASKS 4: 2s = 2000ms = 200 ticks
+    SCH_Ctx_Add_Task(ctx, Task_LED4, 0, 2000 / TIMER_TICK_MS);
+
+    // TASKS 5: 2.5s = 2500ms = 250 ticks
+    SCH_Ctx_Add_Task(ctx, Task_LED5, 0, 2500 / TIMER_TICK_MS);
+}
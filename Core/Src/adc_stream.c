@@ -0,0 +1,168 @@
+#include "adc_stream.h"
+
+#define ADC_FLAG_HALF0      0x01u       // First half complete
+#define ADC_FLAG_HALF1      0x02u       // Second half complete
+
+/*----------------------------------------------------------------------------
+ * Global Variables
+ *---------------------------------------------------------------------------*/
+static uint16_t g_Buffer[2 * ADC_STREAM_FRAMES * ADC_STREAM_MAX_CHANNELS];
+static uint8_t g_Channels;
+static SCH_Flags g_Flags;
+static SCH_Context* g_Ctx;
+static ADC_Stream_Process g_Process;
+static volatile uint32_t g_Overruns;
+static volatile uint8_t g_InUse[2];             // Half handed over, not yet processed
+
+/*----------------------------------------------------------------------------
+ * ADC_Stream_Task() - Process the half (or halves) the DMA completed
+ *---------------------------------------------------------------------------*/
+static void ADC_Stream_Task(void) {
+    uint32_t done = SCH_Ctx_Get_Wake_Flags(g_Ctx);
+    uint16_t half = (uint16_t)(ADC_STREAM_FRAMES * g_Channels);
+
+    if (done & ADC_FLAG_HALF0) {
+        g_Process(&g_Buffer[0], ADC_STREAM_FRAMES, g_Channels);
+        g_InUse[0] = 0;
+    }
+    if (done & ADC_FLAG_HALF1) {
+        g_Process(&g_Buffer[half], ADC_STREAM_FRAMES, g_Channels);
+        g_InUse[1] = 0;
+    }
+}
+
+/*----------------------------------------------------------------------------
+ * ADC_Stream_Init() - Start continuous sampling of 'channels' at rateHz
+ *
+ * Parameters:
+ *   ctx      - Scheduler context the processing task runs in
+ *   channels - ADC1 input numbers in sequence order (0..7 = PA0..PA7,
+ *              8..9 = PB0..PB1); LED pins PA1..PA5 must not be used
+ *   count    - 1..ADC_STREAM_MAX_CHANNELS
+ *   rateHz   - Sequences per second, ADC_STREAM_MIN_HZ up to
+ *              1000000 / (ADC_STREAM_CONV_US x count)
+ *   process  - Called from a task with each completed half
+ *
+ * Returns: 1 on success, 0 on invalid parameters
+ *---------------------------------------------------------------------------*/
+uint8_t ADC_Stream_Init(SCH_Context* ctx, const uint8_t* channels, uint8_t count, uint32_t rateHz,
+                        ADC_Stream_Process process) {
+    GPIO_InitTypeDef gpio = {0};
+    uint32_t sqr3 = 0;
+
+    if (channels == NULL || count == 0 || count > ADC_STREAM_MAX_CHANNELS || process == NULL) {
+        return 0;
+    }
+    if (rateHz < ADC_STREAM_MIN_HZ || rateHz > 1000000u / (ADC_STREAM_CONV_US * count)) {
+        return 0;       // ARR would overflow, or a sequence outlasts the period
+    }
+    for (uint8_t i = 0; i < count; i++) {
+        if (channels[i] > 9) {
+            return 0;
+        }
+    }
+    g_Channels = count;
+    g_Ctx = ctx;
+    g_Process = process;
+    g_Overruns = 0;
+    g_InUse[0] = 0;
+    g_InUse[1] = 0;
+
+    // Completed halves release the processing task
+    SCH_Flags_Init(&g_Flags);
+    SCH_Ctx_Add_Flags(ctx, &g_Flags);
+    if (SCH_Ctx_Add_Flag_Task(ctx, ADC_Stream_Task, &g_Flags, ADC_FLAG_HALF0 | ADC_FLAG_HALF1,
+                              SCH_FLAGS_CLEAR, 0) == NO_TASK_ID) {
+        return 0;
+    }
+
+    __HAL_RCC_GPIOA_CLK_ENABLE();
+    __HAL_RCC_GPIOB_CLK_ENABLE();
+    __HAL_RCC_ADC1_CLK_ENABLE();
+    __HAL_RCC_DMA1_CLK_ENABLE();
+    __HAL_RCC_TIM1_CLK_ENABLE();
+
+    // Analog inputs, sample time 55.5 cycles
+    gpio.Mode = GPIO_MODE_ANALOG;
+    for (uint8_t i = 0; i < count; i++) {
+        uint8_t ch = channels[i];
+
+        gpio.Pin = (ch < 8) ? (uint16_t)(1u << ch) : (uint16_t)(1u << (ch - 8));
+        HAL_GPIO_Init((ch < 8) ? GPIOA : GPIOB, &gpio);
+        ADC1->SMPR2 |= 5u << (3u * ch);
+        sqr3 |= (uint32_t)ch << (5u * i);
+    }
+
+    // DMA1 Channel 1: ADC1->DR into both halves, circular
+    DMA1_Channel1->CCR = 0;
+    DMA1_Channel1->CPAR = (uint32_t)&ADC1->DR;
+    DMA1_Channel1->CMAR = (uint32_t)g_Buffer;
+    DMA1_Channel1->CNDTR = 2u * ADC_STREAM_FRAMES * count;
+    DMA1_Channel1->CCR = DMA_CCR_MINC | DMA_CCR_PSIZE_0 | DMA_CCR_MSIZE_0 | DMA_CCR_CIRC | DMA_CCR_HTIE |
+                         DMA_CCR_TCIE | DMA_CCR_EN;
+    HAL_NVIC_SetPriority(DMA1_Channel1_IRQn, 1, 0);
+    HAL_NVIC_EnableIRQ(DMA1_Channel1_IRQn);
+
+    // ADC1: scan the sequence on each TIM1 CC1 event (EXTSEL = 000)
+    ADC1->CR1 = ADC_CR1_SCAN;
+    ADC1->SQR1 = (uint32_t)(count - 1u) << ADC_SQR1_L_Pos;
+    ADC1->SQR3 = sqr3;
+    ADC1->CR2 = ADC_CR2_ADON;
+    for (volatile uint32_t i = 0; i < 100; i++) {
+        // t_STAB before calibration
+    }
+    ADC1->CR2 |= ADC_CR2_RSTCAL;
+    while (ADC1->CR2 & ADC_CR2_RSTCAL) {
+    }
+    ADC1->CR2 |= ADC_CR2_CAL;
+    while (ADC1->CR2 & ADC_CR2_CAL) {
+    }
+    ADC1->CR2 |= ADC_CR2_DMA | ADC_CR2_EXTTRIG;
+
+    // TIM1: 1 MHz count, one compare 1 edge per period. OC1REF must rise
+    // inside the period: CCR1 = 0 would hold it low and never trigger.
+    TIM1->CR1 = 0;
+    TIM1->PSC = (HAL_RCC_GetPCLK2Freq() / 1000000u) - 1u;
+    TIM1->ARR = (1000000u / rateHz) - 1u;
+    TIM1->CCR1 = (TIM1->ARR + 1u) / 2u;
+    TIM1->CCMR1 = TIM_CCMR1_OC1M_1 | TIM_CCMR1_OC1M_2;     // PWM mode 1
+    TIM1->CCER = TIM_CCER_CC1E;                             // MOE stays off: pin not driven
+    TIM1->EGR = TIM_EGR_UG;
+    TIM1->CR1 = TIM_CR1_CEN;
+    return 1;
+}
+
+uint32_t ADC_Stream_Get_Overruns(void) {
+    return g_Overruns;
+}
+
+/*----------------------------------------------------------------------------
+ * ADC_Stream_DMA_IRQHandler() - A half is complete, release the task
+ *
+ * The flag is cleared as soon as the task is released, so it says nothing
+ * about whether processing finished. g_InUse does: the task clears it after
+ * the half was processed, and a half completing again before that is an
+ * overrun.
+ *---------------------------------------------------------------------------*/
+void ADC_Stream_DMA_IRQHandler(void) {
+    uint32_t isr = DMA1->ISR;
+    uint32_t done = 0;
+
+    if (isr & DMA_ISR_HTIF1) {
+        done |= ADC_FLAG_HALF0;
+    }
+    if (isr & DMA_ISR_TCIF1) {
+        done |= ADC_FLAG_HALF1;
+    }
+    DMA1->IFCR = DMA_IFCR_CGIF1;
+
+    for (uint8_t i = 0; i < 2; i++) {
+        if (done & (1u << i)) {
+            if (g_InUse[i]) {
+                g_Overruns++;
+            }
+            g_InUse[i] = 1;
+        }
+    }
+    SCH_Flags_Set(&g_Flags, done);
+}
@@ -0,0 +1,209 @@
+#include "anim.h"
+#include <stddef.h>
+
+/*----------------------------------------------------------------------------
+ * ANIM_Compile() - Turn keyframes into a delta timeline
+ *
+ * Parameters:
+ *   frames   - Keyframes in time order, the first one at TimeMs 0
+ *   loopMs   - Pattern length when looping (>= last keyframe), 0 = once
+ *   tickMs   - Scheduler tick length, > 0
+ *   steps    - Output buffer of maxSteps entries
+ *   timeline - Set to play 'steps'
+ *
+ * Returns: number of steps, 0 if tickMs is 0, the loop is shorter than
+ * the last keyframe (or than one tick) or the steps do not fit in maxSteps
+ *---------------------------------------------------------------------------*/
+uint16_t ANIM_Compile(const ANIM_Keyframe* frames, uint16_t count, uint16_t loopMs, uint16_t tickMs,
+                      ANIM_Step* steps, uint16_t maxSteps, ANIM_Timeline* timeline) {
+    ANIM_Step* out = steps;
+    uint16_t n = 0;
+    uint32_t lastTick = 0;
+    int16_t lastLevel = -1;             // Nothing emitted yet
+
+    if (tickMs == 0) {
+        return 0;
+    }
+    if (loopMs != 0 &&
+        (loopMs / tickMs == 0 || (count > 0 && loopMs / tickMs < frames[count - 1].TimeMs / tickMs))) {
+        return 0;
+    }
+
+    for (uint16_t i = 0; i < count; i++) {
+        uint32_t tick = frames[i].TimeMs / tickMs;
+
+        // Fade: intermediate steps each time the level moved a quantum
+        if (frames[i].Fade && i > 0) {
+            uint32_t t0 = frames[i - 1].TimeMs / tickMs;
+            int32_t l0 = frames[i - 1].Level;
+            int32_t l1 = frames[i].Level;
+
+            for (uint32_t t = t0 + 1; t < tick; t++) {
+                int32_t level = l0 + (l1 - l0) * (int32_t)(t - t0) / (int32_t)(tick - t0);
+                int32_t moved = level - lastLevel;
+
+                if (moved >= ANIM_FADE_QUANTUM || moved <= -ANIM_FADE_QUANTUM) {
+                    if (n >= maxSteps) {
+                        return 0;
+                    }
+                    out[n].Delta = (uint16_t)(t - lastTick);
+                    out[n].Level = (uint8_t)level;
+                    n++;
+                    lastTick = t;
+                    lastLevel = (int16_t)level;
+                }
+            }
+        }
+
+        if (frames[i].Level != lastLevel) {
+            if (n >= maxSteps) {
+                return 0;
+            }
+            out[n].Delta = (uint16_t)(tick - lastTick);
+            out[n].Level = frames[i].Level;
+            n++;
+            lastTick = tick;
+            lastLevel = frames[i].Level;
+        }
+    }
+
+    timeline->Steps = steps;
+    timeline->Count = n;
+    timeline->LoopTicks = (uint16_t)(loopMs / tickMs);
+    return n;
+}
+
+/*----------------------------------------------------------------------------
+ * ANIM_Arm() - Make sure the player wakes up for its earliest step
+ *
+ * Keeps the pending wakeup if it is early enough, otherwise replaces it.
+ *---------------------------------------------------------------------------*/
+static void ANIM_Run(void* arg);
+
+static void ANIM_Arm(ANIM_Player* player) {
+    uint32_t now = SCH_Ctx_Get_Current_Tick(player->Ctx);
+    uint32_t next = 0;
+    uint8_t any = 0;
+
+    for (uint8_t i = 0; i < player->Count; i++) {
+        if (!any || (int32_t)(player->Channels[i].Due - next) < 0) {
+            next = player->Channels[i].Due;
+            any = 1;
+        }
+    }
+    if (!any) {
+        return;
+    }
+    if (player->TaskID != NO_TASK_ID) {
+        if ((int32_t)(player->WakeAt - next) <= 0) {
+            return;
+        }
+        SCH_Ctx_Delete_Task(player->Ctx, player->TaskID);
+    }
+    player->WakeAt = next;
+    player->TaskID = SCH_Ctx_Add_Task_Arg(player->Ctx, ANIM_Run, player,
+                                          ((int32_t)(next - now) > 0) ? next - now : 0, 0);
+}
+
+/*----------------------------------------------------------------------------
+ * ANIM_Run() - Apply every step that is due, then sleep until the next
+ *
+ * Catches up if the wakeup ran late, so timelines never drift.
+ *---------------------------------------------------------------------------*/
+static void ANIM_Run(void* arg) {
+    ANIM_Player* player = (ANIM_Player*)arg;
+    uint32_t now = SCH_Ctx_Get_Current_Tick(player->Ctx);
+    uint8_t i = 0;
+
+    player->TaskID = NO_TASK_ID;        // This one-shot is freed after the run
+    player->Wakeups++;
+
+    while (i < player->Count) {
+        ANIM_Channel* ch = &player->Channels[i];
+        const ANIM_Timeline* tl = ch->Timeline;
+        uint8_t done = 0;
+
+        while ((int32_t)(now - ch->Due) >= 0) {
+            ch->Write(ch->Id, tl->Steps[ch->Index].Level);
+            ch->Index++;
+            if (ch->Index < tl->Count) {
+                ch->Due += tl->Steps[ch->Index].Delta;
+            } else if (tl->LoopTicks != 0) {
+                ch->Index = 0;
+                ch->Start += tl->LoopTicks;
+                ch->Due = ch->Start + tl->Steps[0].Delta;
+            } else {
+                done = 1;
+                break;
+            }
+        }
+
+        if (done) {
+            // Finished, last channel takes its slot
+            *ch = player->Channels[--player->Count];
+        } else {
+            i++;
+        }
+    }
+    ANIM_Arm(player);
+}
+
+void ANIM_Player_Init(ANIM_Player* player, SCH_Context* ctx) {
+    player->Ctx = ctx;
+    player->Count = 0;
+    player->TaskID = NO_TASK_ID;
+    player->WakeAt = 0;
+    player->Wakeups = 0;
+}
+
+/*----------------------------------------------------------------------------
+ * ANIM_Play() - Start (or restart) a timeline on one LED now
+ *
+ * Returns: 1 on success, 0 if the timeline is empty or the player full
+ *---------------------------------------------------------------------------*/
+uint8_t ANIM_Play(ANIM_Player* player, uint16_t id, ANIM_Write write, const ANIM_Timeline* timeline) {
+    ANIM_Channel* ch = NULL;
+
+    if (timeline->Count == 0) {
+        return 0;
+    }
+    for (uint8_t i = 0; i < player->Count; i++) {
+        if (player->Channels[i].Id == id) {
+            ch = &player->Channels[i];
+        }
+    }
+    if (ch == NULL) {
+        if (player->Count >= ANIM_MAX_CHANNELS) {
+            return 0;
+        }
+        ch = &player->Channels[player->Count++];
+    }
+
+    ch->Write = write;
+    ch->Id = id;
+    ch->Timeline = timeline;
+    ch->Index = 0;
+    ch->Start = SCH_Ctx_Get_Current_Tick(player->Ctx);
+    ch->Due = ch->Start + timeline->Steps[0].Delta;
+    ANIM_Arm(player);
+    return 1;
+}
+
+/*
+ * Stop animating an LED, its level stays as last written. The pending
+ * wakeup is cancelled and re-armed for the remaining LEDs, if any.
+ */
+uint8_t ANIM_Stop(ANIM_Player* player, uint16_t id) {
+    for (uint8_t i = 0; i < player->Count; i++) {
+        if (player->Channels[i].Id == id) {
+            player->Channels[i] = player->Channels[--player->Count];
+            if (player->TaskID != NO_TASK_ID) {
+                SCH_Ctx_Delete_Task(player->Ctx, player->TaskID);
+                player->TaskID = NO_TASK_ID;
+            }
+            ANIM_Arm(player);
+            return 1;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,164 @@
+#include "capture.h"
+
+#define CAP_FLAG_BATCH      0x01u
+
+/*----------------------------------------------------------------------------
+ * Global Variables
+ *---------------------------------------------------------------------------*/
+static CAP_Event g_Ring[CAP_RING_SIZE];
+static volatile uint16_t g_Head;                // Next free entry (ISR)
+static volatile uint16_t g_Tail;                // Next event to hand out (task)
+static volatile uint32_t g_Dropped;             // Edges lost to a full ring
+static SCH_Context* g_Ctx;
+static TIM_HandleTypeDef* g_Tim;
+static SCH_Flags g_Flags;
+static CAP_Handler g_Handler;
+static uint16_t g_Batch;
+static uint8_t g_Edges;
+static uint32_t g_CountHz;
+static uint32_t g_LastTick;                     // For the 32 -> 64 bit tick extension
+static uint32_t g_TickHigh;
+
+/*----------------------------------------------------------------------------
+ * CAP_Task() - Hand all waiting events to the handler
+ *
+ * Runs on a full batch or on the timeout, which restarts after every run
+ * and so also fires with the ring empty; a wrap of the ring is passed as
+ * two calls so the handler always sees contiguous events.
+ *---------------------------------------------------------------------------*/
+static void CAP_Task(void) {
+    uint16_t head = g_Head;
+    uint16_t tail = g_Tail;
+
+    while (tail != head) {
+        uint16_t end = (head > tail) ? head : CAP_RING_SIZE;
+
+        g_Handler(&g_Ring[tail], (uint16_t)(end - tail));
+        tail = (end == CAP_RING_SIZE) ? 0 : end;
+        g_Tail = tail;
+    }
+}
+
+/*----------------------------------------------------------------------------
+ * CAP_Init() - Start timestamping edges on PA0 (TIM2 CH1)
+ *
+ * Parameters:
+ *   ctx          - Scheduler context whose tick TIM2 drives
+ *   htim         - TIM2 handle, initialized, before HAL_TIM_Base_Start_IT()
+ *   countHz      - Counter rate to re-time TIM2 to, 0 = keep
+ *   edges        - CAP_EDGE_*
+ *   batch        - Events per handler call (1..CAP_RING_SIZE - 1)
+ *   timeoutTicks - Also run this long after the previous run, 0 = never
+ *   handler      - Called from a task with the captured events
+ *
+ * Returns: 1 on success, 0 on invalid parameters
+ *---------------------------------------------------------------------------*/
+uint8_t CAP_Init(SCH_Context* ctx, TIM_HandleTypeDef* htim, uint32_t countHz, uint8_t edges, uint16_t batch,
+                 uint32_t timeoutTicks, CAP_Handler handler) {
+    GPIO_InitTypeDef gpio = {0};
+    uint32_t tickCounts = htim->Init.Period + 1u;
+
+    if (batch == 0 || batch >= CAP_RING_SIZE || (edges & CAP_EDGE_BOTH) == 0 || handler == NULL) {
+        return 0;
+    }
+    g_Ctx = ctx;
+    g_Tim = htim;
+    g_Handler = handler;
+    g_Batch = batch;
+    g_Edges = edges;
+    g_Head = 0;
+    g_Tail = 0;
+    g_Dropped = 0;
+    g_LastTick = SCH_Ctx_Get_Current_Tick(ctx);
+    g_TickHigh = 0;
+
+    // Same tick length at the new counter rate
+    if (countHz != 0) {
+        uint32_t timerHz = HAL_RCC_GetPCLK1Freq();
+        uint32_t tickUs = (uint32_t)(((uint64_t)tickCounts * (htim->Init.Prescaler + 1u) * 1000000u) / timerHz);
+
+        htim->Init.Prescaler = (timerHz / countHz) - 1u;
+        htim->Init.Period = (uint32_t)(((uint64_t)countHz * tickUs) / 1000000u) - 1u;
+        if (htim->Init.Period > 0xFFFFu || HAL_TIM_Base_Init(htim) != HAL_OK) {
+            return 0;
+        }
+    }
+    g_CountHz = HAL_RCC_GetPCLK1Freq() / (htim->Init.Prescaler + 1u);
+
+    SCH_Flags_Init(&g_Flags);
+    SCH_Ctx_Add_Flags(ctx, &g_Flags);
+    if (SCH_Ctx_Add_Flag_Task(ctx, CAP_Task, &g_Flags, CAP_FLAG_BATCH, SCH_FLAGS_CLEAR, timeoutTicks) ==
+        NO_TASK_ID) {
+        return 0;
+    }
+
+    __HAL_RCC_GPIOA_CLK_ENABLE();
+    gpio.Pin = GPIO_PIN_0;
+    gpio.Mode = GPIO_MODE_INPUT;
+    gpio.Pull = GPIO_NOPULL;
+    HAL_GPIO_Init(GPIOA, &gpio);
+
+    // CC1 = TI1, filter 4 samples, rising first (falling if only falling)
+    htim->Instance->CCER &= ~(TIM_CCER_CC1E | TIM_CCER_CC1P);
+    htim->Instance->CCMR1 = (htim->Instance->CCMR1 & ~(TIM_CCMR1_CC1S | TIM_CCMR1_IC1F | TIM_CCMR1_IC1PSC)) |
+                            TIM_CCMR1_CC1S_0 | TIM_CCMR1_IC1F_1;
+    if (edges == CAP_EDGE_FALLING) {
+        htim->Instance->CCER |= TIM_CCER_CC1P;
+    }
+    htim->Instance->CCER |= TIM_CCER_CC1E;
+    __HAL_TIM_ENABLE_IT(htim, TIM_IT_CC1);
+    return 1;
+}
+
+uint32_t CAP_Get_Count_Hz(void) {
+    return g_CountHz;
+}
+
+uint32_t CAP_Get_Dropped(void) {
+    return g_Dropped;
+}
+
+/*----------------------------------------------------------------------------
+ * CAP_Capture_IRQHandler() - Timestamp one edge (HAL_TIM_IC_CaptureCallback)
+ *
+ * Runs before the update of the same interrupt is handled, so a pending
+ * update with a small capture value means the edge came after the wrap.
+ *---------------------------------------------------------------------------*/
+void CAP_Capture_IRQHandler(void) {
+    TIM_TypeDef* tim = g_Tim->Instance;
+    uint32_t ccr = tim->CCR1;
+    uint32_t period = tim->ARR + 1u;
+    uint32_t tick = SCH_Ctx_Get_Current_Tick(g_Ctx);
+    uint8_t rising = (tim->CCER & TIM_CCER_CC1P) == 0;
+    uint16_t head = g_Head;
+    uint16_t next = (uint16_t)((head + 1u) % CAP_RING_SIZE);
+    uint64_t ticks;
+    uint16_t waiting;
+
+    if (tick < g_LastTick) {
+        g_TickHigh++;
+    }
+    g_LastTick = tick;
+    ticks = ((uint64_t)g_TickHigh << 32) | tick;
+    if ((tim->SR & TIM_SR_UIF) != 0 && ccr < period / 2u) {
+        ticks++;
+    }
+
+    // Both edges: listen for the opposite one next
+    if (g_Edges == CAP_EDGE_BOTH) {
+        tim->CCER ^= TIM_CCER_CC1P;
+    }
+
+    if (next == g_Tail) {
+        g_Dropped++;
+        return;
+    }
+    g_Ring[head].Time = ticks * period + ccr;
+    g_Ring[head].Rising = rising;
+    g_Head = next;
+
+    waiting = (uint16_t)((next + CAP_RING_SIZE - g_Tail) % CAP_RING_SIZE);
+    if (waiting >= g_Batch) {
+        SCH_Flags_Set(&g_Flags, CAP_FLAG_BATCH);
+    }
+}
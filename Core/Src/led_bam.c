@@ -0,0 +1,120 @@
+#include "led_bam.h"
+
+/*----------------------------------------------------------------------------
+ * Global Variables
+ *---------------------------------------------------------------------------*/
+static GPIO_TypeDef* g_Port;
+static uint16_t g_Pins;                         // Pins driven by the engine
+static uint8_t g_Levels[16];                    // Per pin number
+static uint32_t g_Planes[2][LED_BAM_BITS];      // BSRR word per bit plane
+static volatile uint8_t g_Active;               // Plane buffer shown by the ISR
+static volatile uint8_t g_SwapPending;          // Other buffer is ready
+static uint8_t g_Plane;                         // Plane the ISR enters next
+
+/*----------------------------------------------------------------------------
+ * LED_BAM_Build() - Compute the BSRR words of all planes into 'planes'
+ *
+ * Each word sets the pins whose level has bit k and resets the others,
+ * so one write per plane drives the whole pin set.
+ *---------------------------------------------------------------------------*/
+static void LED_BAM_Build(uint32_t* planes) {
+    for (uint8_t k = 0; k < LED_BAM_BITS; k++) {
+        uint32_t set = 0;
+
+        for (uint8_t pin = 0; pin < 16; pin++) {
+            if ((g_Pins & (1u << pin)) != 0 && (g_Levels[pin] & (1u << k)) != 0) {
+                set |= 1u << pin;
+            }
+        }
+        planes[k] = set | ((uint32_t)(g_Pins & ~set) << 16);
+    }
+}
+
+/*----------------------------------------------------------------------------
+ * LED_BAM_Init() - Start bit-angle modulation of 'pins' of 'port'
+ *
+ * The pins must already be push-pull outputs (MX_GPIO_Init). All levels
+ * start at 0. TIM3 runs at the highest interrupt priority, like the tick.
+ *---------------------------------------------------------------------------*/
+void LED_BAM_Init(GPIO_TypeDef* port, uint16_t pins) {
+    g_Port = port;
+    g_Pins = pins;
+    g_Active = 0;
+    g_SwapPending = 0;
+    g_Plane = 0;
+    for (uint8_t pin = 0; pin < 16; pin++) {
+        g_Levels[pin] = 0;
+    }
+    LED_BAM_Build(g_Planes[0]);
+
+    __HAL_RCC_TIM3_CLK_ENABLE();
+    TIM3->CR1 = 0;                              // Up counting, ARR not preloaded
+    TIM3->PSC = (HAL_RCC_GetPCLK1Freq() / 1000000u) - 1u;
+    TIM3->ARR = LED_BAM_UNIT_US - 1u;
+    TIM3->EGR = TIM_EGR_UG;                     // Load PSC
+    TIM3->SR = 0;
+    TIM3->DIER = TIM_DIER_UIE;
+
+    HAL_NVIC_SetPriority(TIM3_IRQn, 0, 0);
+    HAL_NVIC_EnableIRQ(TIM3_IRQn);
+    TIM3->CR1 |= TIM_CR1_CEN;
+}
+
+/*----------------------------------------------------------------------------
+ * LED_BAM_Set() - Set the level (0..LED_BAM_MAX) of one pin (GPIO_PIN_x)
+ *
+ * Rebuilds the idle plane buffer and hands it to the ISR for the next
+ * frame. Call from tasks, not interrupts.
+ *---------------------------------------------------------------------------*/
+void LED_BAM_Set(uint16_t pin, uint8_t level) {
+    uint8_t n = 0;
+
+    if ((pin & g_Pins) == 0) {
+        return;
+    }
+    while ((pin & (1u << n)) == 0) {
+        n++;
+    }
+    g_Levels[n] = level;
+
+    // The ISR must not swap to a half-built buffer
+    g_SwapPending = 0;
+    LED_BAM_Build(g_Planes[g_Active ^ 1u]);
+    g_SwapPending = 1;
+}
+
+uint8_t LED_BAM_Get(uint16_t pin) {
+    uint8_t n = 0;
+
+    if ((pin & g_Pins) == 0) {
+        return 0;
+    }
+    while ((pin & (1u << n)) == 0) {
+        n++;
+    }
+    return g_Levels[n];
+}
+
+/* Blink step: off -> full, anything else -> off */
+void LED_BAM_Toggle(uint16_t pin) {
+    LED_BAM_Set(pin, (LED_BAM_Get(pin) == 0) ? LED_BAM_MAX : 0);
+}
+
+/*----------------------------------------------------------------------------
+ * LED_BAM_IRQHandler() - Enter the next bit plane (TIM3 update)
+ *
+ * The counter restarted at the update, so the new ARR applies to the
+ * plane that starts now.
+ *---------------------------------------------------------------------------*/
+void LED_BAM_IRQHandler(void) {
+    uint8_t k = g_Plane;
+
+    TIM3->SR = (uint32_t)~TIM_SR_UIF;
+    if (k == 0 && g_SwapPending) {
+        g_Active ^= 1u;
+        g_SwapPending = 0;
+    }
+    g_Port->BSRR = g_Planes[g_Active][k];
+    TIM3->ARR = (LED_BAM_UNIT_US << k) - 1u;
+    g_Plane = (k + 1u < LED_BAM_BITS) ? (uint8_t)(k + 1u) : 0;
+}
@@ -0,0 +1,81 @@
+#include "led_pwm.h"
+
+/*----------------------------------------------------------------------------
+ * Channel Map (index 0..2 = LED1..LED3)
+ *---------------------------------------------------------------------------*/
+static const uint32_t g_Channels[LED_PWM_COUNT] = { TIM_CHANNEL_2, TIM_CHANNEL_3, TIM_CHANNEL_4 };
+
+static TIM_HandleTypeDef* g_Tim;
+static uint16_t g_OnLevel[LED_PWM_COUNT] = { LED_PWM_STEPS, LED_PWM_STEPS, LED_PWM_STEPS };
+
+/*----------------------------------------------------------------------------
+ * LED_PWM_Init() - Route PA1..PA3 to TIM2 and start PWM on CH2..CH4
+ *
+ * Call after MX_TIM2_Init() and before the tick timer is started. The
+ * timer is re-initialized with the same 10 ms update period (8 MHz HSI:
+ * 80 x 1000), so SCH_Update() keeps its rate. All LEDs start off.
+ *---------------------------------------------------------------------------*/
+void LED_PWM_Init(TIM_HandleTypeDef* htim) {
+    GPIO_InitTypeDef gpio = {0};
+    TIM_OC_InitTypeDef oc = {0};
+
+    g_Tim = htim;
+
+    htim->Init.Prescaler = (HAL_RCC_GetPCLK1Freq() / 100000u) - 1u;
+    htim->Init.Period = LED_PWM_STEPS - 1u;
+    if (HAL_TIM_PWM_Init(htim) != HAL_OK) {
+        Error_Handler();
+    }
+
+    oc.OCMode = TIM_OCMODE_PWM1;
+    oc.Pulse = 0;
+    oc.OCPolarity = TIM_OCPOLARITY_HIGH;
+    oc.OCFastMode = TIM_OCFAST_DISABLE;
+    for (uint8_t i = 0; i < LED_PWM_COUNT; i++) {
+        if (HAL_TIM_PWM_ConfigChannel(htim, &oc, g_Channels[i]) != HAL_OK) {
+            Error_Handler();
+        }
+    }
+
+    // Pins were plain outputs (MX_GPIO_Init), hand them to the timer
+    gpio.Pin = LED1_Pin | LED2_Pin | LED3_Pin;
+    gpio.Mode = GPIO_MODE_AF_PP;
+    gpio.Speed = GPIO_SPEED_FREQ_LOW;
+    HAL_GPIO_Init(GPIOA, &gpio);
+
+    for (uint8_t i = 0; i < LED_PWM_COUNT; i++) {
+        HAL_TIM_PWM_Start(htim, g_Channels[i]);
+    }
+}
+
+/* Brightness 0 (off) .. LED_PWM_STEPS (fully on), from the next tick on */
+void LED_PWM_Set(uint8_t led, uint16_t level) {
+    if (led >= LED_PWM_COUNT || g_Tim == NULL) {
+        return;
+    }
+    if (level > LED_PWM_STEPS) {
+        level = LED_PWM_STEPS;
+    }
+    __HAL_TIM_SET_COMPARE(g_Tim, g_Channels[led], level);
+}
+
+uint16_t LED_PWM_Get(uint8_t led) {
+    if (led >= LED_PWM_COUNT || g_Tim == NULL) {
+        return 0;
+    }
+    return (uint16_t)__HAL_TIM_GET_COMPARE(g_Tim, g_Channels[led]);
+}
+
+/* Brightness used by LED_PWM_Toggle() for the on state */
+void LED_PWM_Set_On_Level(uint8_t led, uint16_t level) {
+    if (led < LED_PWM_COUNT) {
+        g_OnLevel[led] = (level > LED_PWM_STEPS) ? LED_PWM_STEPS : level;
+    }
+}
+
+/* Blink step: off -> on level, anything else -> off */
+void LED_PWM_Toggle(uint8_t led) {
+    if (led < LED_PWM_COUNT) {
+        LED_PWM_Set(led, (LED_PWM_Get(led) == 0) ? g_OnLevel[led] : 0);
+    }
+}
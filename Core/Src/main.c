@@ -24,6 +24,11 @@
 /* USER CODE BEGIN Includes */
 #include "scheduler.h"
 #include "Tasks.h"
+#include "sch_bench.h"
+#include "led_pwm.h"
+#include "led_bam.h"
+#include "adc_stream.h"
+#include "capture.h"
 /* USER CODE END Includes */
 
 /* Private typedef -----------------------------------------------------------*/
@@ -57,6 +62,41 @@ static void MX_TIM2_Init(void);
 
 /* Private user code ---------------------------------------------------------*/
 /* USER CODE BEGIN 0 */
+#ifdef ADC_STREAM_ENABLE
+static const uint8_t g_AdcChannels[] = { 7 };  // PA7 (PA0 is the capture input)
+volatile uint16_t g_AdcLevel;                   // Mean of the last block
+
+static void ADC_Block(const uint16_t* block, uint16_t frames, uint8_t channels) {
+  uint32_t sum = 0;
+
+  for (uint16_t i = 0; i < frames; i++) {
+    sum += block[i * channels];
+  }
+  g_AdcLevel = (uint16_t)(sum / frames);
+}
+#endif
+
+#ifdef CAPTURE_ENABLE
+#ifdef LED_DRIVER_PWM
+#define CAPTURE_COUNT_HZ  0                     // Keep the PWM timebase (10 us steps)
+#else
+#define CAPTURE_COUNT_HZ  1000000               // 1 us steps
+#endif
+volatile uint32_t g_CapturePeriod;              // Last rising-to-rising time (counter steps)
+
+static void Capture_Batch(const CAP_Event* events, uint16_t count) {
+  static uint64_t lastRise;
+
+  for (uint16_t i = 0; i < count; i++) {
+    if (events[i].Rising) {
+      if (lastRise != 0) {
+        g_CapturePeriod = (uint32_t)(events[i].Time - lastRise);
+      }
+      lastRise = events[i].Time;
+    }
+  }
+}
+#endif
 
 /* USER CODE END 0 */
 
@@ -67,6 +107,10 @@ static void MX_TIM2_Init(void);
 int main(void)
 {
   /* USER CODE BEGIN 1 */
+#ifdef SCH_BENCHMARK
+  // Benchmark configuration: measure the scheduler and exit (never returns)
+  SCH_Bench_Run();
+#endif
 
   /* USER CODE END 1 */
 
@@ -93,22 +137,25 @@ int main(void)
 
   // Initialize scheduler
   SCH_Init();
+#ifdef LED_DRIVER_PWM
+  // LED1..LED3 dimmed and blinked by TIM2 CH2..CH4 (tick period unchanged)
+  LED_PWM_Init(&htim2);
+#endif
+#ifdef LED_DRIVER_BAM
+  // LED4/LED5 dimmed by bit-angle modulation on TIM3
+  LED_BAM_Init(GPIOA, LED4_Pin | LED5_Pin);
+#endif
+#ifdef ADC_STREAM_ENABLE
+  // PA7 sampled at 1 kHz, processed in blocks of ADC_STREAM_FRAMES
+  ADC_Stream_Init(SCH_Get_Default_Context(), g_AdcChannels, 1, 1000, ADC_Block);
+#endif
+#ifdef CAPTURE_ENABLE
+  // PA0 edges timestamped, handled 8 at a time or 100ms after the last batch
+  CAP_Init(SCH_Get_Default_Context(), &htim2, CAPTURE_COUNT_HZ, CAP_EDGE_BOTH, 8, 10, Capture_Batch);
+#endif
   //         ============== ADD TASKS =============
 
-  // TASKS 1: 0.5s = 500ms = 50 ticks
-    SCH_Add_Task(Task_LED1, 0, 500 / TIMER_TICK_MS);
-
-    // TASKS 2: 1s = 1000ms = 100 ticks
-    SCH_Add_Task(Task_LED2, 0, 1000 / TIMER_TICK_MS);
-
-    // TASKS 3: 1.5s = 1500ms = 150 ticks
-    SCH_Add_Task(Task_LED3, 0, 1500 / TIMER_TICK_MS);
-
-    // TASKS 4: 2s = 2000ms = 200 ticks
-    SCH_Add_Task(Task_LED4, 0, 2000 / TIMER_TICK_MS);
-
-    // TASKS 5: 2.5s = 2500ms = 250 ticks
-    SCH_Add_Task(Task_LED5, 0, 2500 / TIMER_TICK_MS);
+    Tasks_Register(SCH_Get_Default_Context());
 
     //      ============= END ADD TASKS ===========
 
@@ -241,6 +288,15 @@ void HAL_TIM_PeriodElapsedCallback(TIM_HandleTypeDef *htim)
     }
 }
 
+#ifdef CAPTURE_ENABLE
+void HAL_TIM_IC_CaptureCallback(TIM_HandleTypeDef *htim)
+{
+    if (htim->Instance == TIM2 && htim->Channel == HAL_TIM_ACTIVE_CHANNEL_1) {
+        CAP_Capture_IRQHandler();
+    }
+}
+#endif
+
 /* USER CODE END 4 */
 
 /**
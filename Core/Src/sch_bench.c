@@ -0,0 +1,255 @@
+#include "sch_bench.h"
+
+#ifdef SCH_BENCHMARK
+
+#include "main.h"
+#include "scheduler.h"
+
+/*----------------------------------------------------------------------------
+ * Semihosting (ARM angel interface, BKPT 0xAB on Cortex-M)
+ *
+ * Called directly instead of through newlib's rdimon so the benchmark
+ * image links with the same syscalls.c as the application.
+ *---------------------------------------------------------------------------*/
+#define SEMI_SYS_WRITE0             0x04
+#define SEMI_SYS_EXIT               0x18
+#define SEMI_ADP_APPLICATION_EXIT   0x20026
+
+static uint32_t Semi_Call(uint32_t op, const void* arg) {
+    register uint32_t r0 __asm__("r0") = op;
+    register const void* r1 __asm__("r1") = arg;
+
+    __asm__ volatile ("bkpt 0xAB" : "+r"(r0) : "r"(r1) : "memory");
+    return r0;
+}
+
+/*----------------------------------------------------------------------------
+ * Cycle Counter - DWT CYCCNT, or SysTick (24 bit, CPU clock) when the
+ * DWT is not implemented, as in QEMU
+ *---------------------------------------------------------------------------*/
+static uint8_t g_UseDwt;
+
+static void Bench_Counter_Init(void) {
+    SysTick->CTRL = 0;
+    SysTick->LOAD = SysTick_LOAD_RELOAD_Msk;
+    SysTick->VAL = 0;
+    SysTick->CTRL = SysTick_CTRL_CLKSOURCE_Msk | SysTick_CTRL_ENABLE_Msk;
+
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+    uint32_t start = DWT->CYCCNT;
+    for (volatile uint32_t i = 0; i < 16; i++) {
+    }
+    g_UseDwt = (DWT->CYCCNT != start);
+}
+
+static inline uint32_t Bench_Now(void) {
+    if (g_UseDwt) {
+        return DWT->CYCCNT;
+    }
+    return ~SysTick->VAL & SysTick_LOAD_RELOAD_Msk;    // Counts down
+}
+
+static inline uint32_t Bench_Elapsed(uint32_t start) {
+    uint32_t delta = Bench_Now() - start;
+    return g_UseDwt ? delta : (delta & SysTick_LOAD_RELOAD_Msk);
+}
+
+/*----------------------------------------------------------------------------
+ * Report Helpers
+ *---------------------------------------------------------------------------*/
+typedef struct {
+    uint32_t Min;
+    uint32_t Max;
+    uint32_t Sum;
+    uint32_t Count;
+} Bench_Stat;
+
+static char g_Line[96];
+static uint32_t g_Overhead;        // Cost of an empty Bench_Now()/Elapsed pair
+
+static char* Bench_Put_Str(char* p, const char* s) {
+    while (*s != '\0') {
+        *p++ = *s++;
+    }
+    return p;
+}
+
+static char* Bench_Put_U32(char* p, uint32_t v) {
+    char digits[10];
+    int n = 0;
+
+    do {
+        digits[n++] = (char)('0' + v % 10);
+        v /= 10;
+    } while (v != 0);
+    while (n > 0) {
+        *p++ = digits[--n];
+    }
+    return p;
+}
+
+static void Bench_Stat_Add(Bench_Stat* s, uint32_t cycles) {
+    cycles = (cycles > g_Overhead) ? cycles - g_Overhead : 0;
+    if (s->Count == 0 || cycles < s->Min) {
+        s->Min = cycles;
+    }
+    if (cycles > s->Max) {
+        s->Max = cycles;
+    }
+    s->Sum += cycles;
+    s->Count++;
+}
+
+static void Bench_Report(const char* op, uint32_t tasks, const Bench_Stat* s) {
+    char* p = g_Line;
+
+    p = Bench_Put_Str(p, op);
+    p = Bench_Put_Str(p, " n=");
+    p = Bench_Put_U32(p, tasks);
+    p = Bench_Put_Str(p, " reps=");
+    p = Bench_Put_U32(p, s->Count);
+    p = Bench_Put_Str(p, " min=");
+    p = Bench_Put_U32(p, s->Min);
+    p = Bench_Put_Str(p, " avg=");
+    p = Bench_Put_U32(p, s->Count ? s->Sum / s->Count : 0);
+    p = Bench_Put_Str(p, " max=");
+    p = Bench_Put_U32(p, s->Max);
+    p = Bench_Put_Str(p, "\n");
+    *p = '\0';
+    Semi_Call(SEMI_SYS_WRITE0, g_Line);
+}
+
+/*----------------------------------------------------------------------------
+ * Workload
+ *---------------------------------------------------------------------------*/
+static SCH_Context g_BenchContext;
+static uint32_t g_TaskIDs[SCH_BENCH_MAX_TASKS];
+static volatile uint32_t g_Runs;
+static uint32_t g_Seed = 0x2310797u;
+
+static uint32_t Bench_Rand(void) {
+    // xorshift32: fixed sequence so every run measures the same lists
+    g_Seed ^= g_Seed << 13;
+    g_Seed ^= g_Seed >> 17;
+    g_Seed ^= g_Seed << 5;
+    return g_Seed;
+}
+
+static uint32_t Bench_Delay(void) {
+    return 1 + Bench_Rand() % 1000;
+}
+
+static void Bench_Task(void) {
+    g_Runs++;
+}
+
+/* Time each scheduler operation with 'tasks' tasks already in the list */
+static uint8_t Bench_Measure(uint32_t tasks) {
+    SCH_Context* ctx = &g_BenchContext;
+    Bench_Stat add = { 0 }, del = { 0 }, update = { 0 }, dispatch = { 0 };
+    uint32_t start, cycles, id;
+
+    SCH_Ctx_Deinit(ctx);
+    SCH_Ctx_Init(ctx);
+    for (uint32_t i = 0; i < tasks; i++) {
+        uint32_t delay = Bench_Delay();
+        g_TaskIDs[i] = SCH_Ctx_Add_Task(ctx, Bench_Task, delay, delay);
+        if (g_TaskIDs[i] == NO_TASK_ID) {
+            return 0;
+        }
+    }
+
+    // Add one more task, then take it out again untimed
+    for (uint32_t r = 0; r < SCH_BENCH_REPS; r++) {
+        uint32_t delay = Bench_Delay();
+        start = Bench_Now();
+        id = SCH_Ctx_Add_Task(ctx, Bench_Task, delay, delay);
+        cycles = Bench_Elapsed(start);
+        if (id == NO_TASK_ID) {
+            return 0;
+        }
+        Bench_Stat_Add(&add, cycles);
+        SCH_Ctx_Delete_Task(ctx, id);
+    }
+
+    // Delete a random task, then put a replacement back untimed
+    for (uint32_t r = 0; r < SCH_BENCH_REPS; r++) {
+        uint32_t k = Bench_Rand() % tasks;
+        uint32_t delay = Bench_Delay();
+        start = Bench_Now();
+        SCH_Ctx_Delete_Task(ctx, g_TaskIDs[k]);
+        cycles = Bench_Elapsed(start);
+        Bench_Stat_Add(&del, cycles);
+        g_TaskIDs[k] = SCH_Ctx_Add_Task(ctx, Bench_Task, delay, delay);
+    }
+
+    // One tick; due tasks are run untimed so every sample counts down
+    for (uint32_t r = 0; r < SCH_BENCH_REPS; r++) {
+        if (SCH_Ctx_Get_Ticks_To_Next(ctx) == 0) {
+            SCH_Ctx_Dispatch_Tasks(ctx);
+        }
+        start = Bench_Now();
+        SCH_Ctx_Update(ctx);
+        cycles = Bench_Elapsed(start);
+        Bench_Stat_Add(&update, cycles);
+    }
+
+    // Dispatch cost per task run (includes reinsertion of periodic tasks)
+    for (uint32_t r = 0; r < SCH_BENCH_REPS; r++) {
+        SCH_Ctx_Advance(ctx, SCH_Ctx_Get_Ticks_To_Next(ctx));
+        g_Runs = 0;
+        start = Bench_Now();
+        SCH_Ctx_Dispatch_Tasks(ctx);
+        cycles = Bench_Elapsed(start);
+        Bench_Stat_Add(&dispatch, g_Runs ? cycles / g_Runs : cycles);
+    }
+
+    Bench_Report("add", tasks, &add);
+    Bench_Report("delete", tasks, &del);
+    Bench_Report("update", tasks, &update);
+    Bench_Report("dispatch", tasks, &dispatch);
+
+    // Free every node before the next, larger run
+    for (uint32_t i = 0; i < tasks; i++) {
+        SCH_Ctx_Delete_Task(ctx, g_TaskIDs[i]);
+    }
+    return 1;
+}
+
+/*----------------------------------------------------------------------------
+ * SCH_Bench_Run() - Measure, report and end the session (does not return)
+ *---------------------------------------------------------------------------*/
+void SCH_Bench_Run(void) {
+    static const uint32_t taskCounts[] = { 1, 4, 16, 32, SCH_BENCH_MAX_TASKS };
+    uint32_t start;
+
+    __disable_irq();
+    Bench_Counter_Init();
+
+    g_Overhead = 0xFFFFFFFFu;
+    for (uint32_t r = 0; r < 16; r++) {
+        start = Bench_Now();
+        uint32_t cycles = Bench_Elapsed(start);
+        if (cycles < g_Overhead) {
+            g_Overhead = cycles;
+        }
+    }
+
+    Semi_Call(SEMI_SYS_WRITE0, g_UseDwt ? "SCHBENCH 1 counter=dwt\n" : "SCHBENCH 1 counter=systick\n");
+    for (uint32_t i = 0; i < sizeof(taskCounts) / sizeof(taskCounts[0]); i++) {
+        if (!Bench_Measure(taskCounts[i])) {
+            Semi_Call(SEMI_SYS_WRITE0, "error out of memory\n");
+            break;
+        }
+    }
+    Semi_Call(SEMI_SYS_WRITE0, "SCHBENCH END\n");
+
+    Semi_Call(SEMI_SYS_EXIT, (const void*)SEMI_ADP_APPLICATION_EXIT);
+    while (1) {
+    }
+}
+
+#endif // SCH_BENCHMARK
@@ -7,42 +7,389 @@
  *---------------------------------------------------------------------------*/
 typedef struct TaskNode {
     void (*pTask)(void);           // Function pointer to task
+    void (*pTaskArg)(void*);        // Alternative task taking an argument
+    void* Arg;                      // Argument passed to pTaskArg
     uint32_t Delay;                 // Delta delay to next execution
     uint32_t Period;                // Repeat interval (0 = one-shot)
+    uint32_t Slack;                 // Allowed lateness per release (ticks)
+    uint32_t SlackUsed;             // Lateness chosen for the pending release
     uint32_t TaskID;                // Unique identifier
+    SCH_Mode* Mode;                 // Owning mode, NULL = always active
+    uint8_t Criticality;            // SCH_CRIT_*, low levels are shed first
+    uint32_t MinPeriod;             // Elastic range, MaxPeriod == 0: fixed
+    uint32_t MaxPeriod;
+    SCH_Partition* Partition;       // Budget group, NULL = unlimited
+    struct SCH_TaskExt* Ext;        // Trigger state, NULL for plain timed tasks
     struct TaskNode* next;          // Next task in sorted list
 } TaskNode;
 
+/* Dependency edge, owned by the predecessor */
+typedef struct SCH_Edge {
+    TaskNode* To;
+    uint16_t Round;                 // Round of To in which this edge last completed
+    struct SCH_Edge* next;
+} SCH_Edge;
+
+/*
+ * Trigger state, allocated only for tasks that take part in a chain
+ * (predecessors and triggered tasks) or wait for event flags, so plain
+ * timed tasks keep a small node.
+ */
+typedef struct SCH_TaskExt {
+    SCH_Edge* Successors;           // Tasks released when this one completes
+    uint16_t Waits;                 // Number of predecessors (triggered tasks)
+    uint16_t Pending;               // Predecessors still to complete this round
+    uint16_t Round;                 // Releases so far, tells edges' rounds apart
+    uint8_t Trigger;                // SCH_TRIG_*
+    uint8_t FlagOptions;            // SCH_FLAGS_*
+    SCH_Flags* Flags;               // Event flag group waited on, NULL = none
+    uint32_t FlagMask;
+    uint32_t Timeout;               // Ticks to wait for the flags, 0 = forever
+    uint32_t WakeFlags;             // Flags that released the pending run
+    uint32_t FlagPass;              // Dispatch pass of the last flag release
+    uint32_t Visit;                 // Cycle check mark (SCH_Reaches)
+    TaskNode* NextWaiter;           // Next waiter of the same group
+} SCH_TaskExt;
+
+/* Trigger states of a task */
+#define SCH_TRIG_NONE       0       // Timed task
+#define SCH_TRIG_PARKED     1       // Triggered task waiting for predecessors
+#define SCH_TRIG_RELEASED   2       // Triggered task due in the context list
+#define SCH_TRIG_TIMED      3       // Flag waiter with a timeout in the context list
+
+#define SCH_TRIGGER_OF(node)    (((node)->Ext != NULL) ? (node)->Ext->Trigger : SCH_TRIG_NONE)
+
 /*----------------------------------------------------------------------------
  * Global Variables
  *---------------------------------------------------------------------------*/
-static TaskNode* g_TaskListHead = NULL;  // Head of sorted task list
-static uint32_t g_CurrentTick = 0;        // System tick counter (10ms each)
-static uint32_t g_NextTaskID = 1;         // Auto-increment task ID
-static uint8_t g_ErrorCode = 0;           // Error code register
+static SCH_Context g_DefaultContext = {     // Used by SCH_* API
+    .NextTaskID = 1,
+    .ElasticScale = SCH_ELASTIC_ONE,
+};
+
+/*----------------------------------------------------------------------------
+ * SCH_List_Of() - The sorted list a task belongs to
+ *
+ * Tasks added with SCH_Ctx_Add_Task() live in the context's own list and
+ * are always active; mode tasks live in the list of their mode.
+ *---------------------------------------------------------------------------*/
+static TaskNode** SCH_List_Of(SCH_Context* ctx, TaskNode* node) {
+    return (node->Mode != NULL) ? &node->Mode->TaskListHead : &ctx->TaskListHead;
+}
+
+/*----------------------------------------------------------------------------
+ * SCH_Insert_Node() - Link a node into its sorted list
+ *
+ * Uses the DELTA TIME technique:
+ *
+ * Example: Tasks at 10ms, 25ms, 30ms stored as:
+ * Head -> [10] -> [15] -> [5] -> NULL
+ *         ^^^     ^^^     ^^^
+ *       10-0    25-10   30-25
+ *
+ * Tasks with equal delay keep insertion order (new task goes after them).
+ *---------------------------------------------------------------------------*/
+static void SCH_Insert_Node(SCH_Context* ctx, TaskNode* node, uint32_t delay) {
+    TaskNode** list = SCH_List_Of(ctx, node);
+
+    if (*list == NULL || delay < (*list)->Delay) {
+        // Insert at head
+        node->Delay = delay;
+        if (*list != NULL) {
+            (*list)->Delay -= delay;
+        }
+        node->next = *list;
+        *list = node;
+    } else {
+        // Find insertion point
+        TaskNode* current = *list;
+        uint32_t accumulatedTime = (*list)->Delay;
+
+        while (current->next != NULL &&
+               accumulatedTime + current->next->Delay <= delay) {
+            accumulatedTime += current->next->Delay;
+            current = current->next;
+        }
+
+        // Insert after current
+        node->Delay = delay - accumulatedTime;
+        node->next = current->next;
+
+        if (current->next != NULL) {
+            current->next->Delay -= node->Delay;
+        }
+
+        current->next = node;
+    }
+}
+
+/*----------------------------------------------------------------------------
+ * SCH_Insert_Slack() - Link a node at a release tick within its slack
+ *
+ * The task may run anywhere in [delay, delay + Slack]. To share wakeups:
+ * 1. Join the earliest release tick already in the list inside the window
+ * 2. Otherwise pick the tick in the window aligned to the largest power
+ *    of two <= Slack + 1, so unrelated slack tasks tend to meet
+ *
+ * Example: delay 7, slack 4, list releases at 5 and 9:
+ *   Window [7..11] -> joins 9 (one wakeup saved)
+ *
+ * Complexity: O(n), one extra walk of the list for slack tasks only
+ *---------------------------------------------------------------------------*/
+static void SCH_Insert_Slack(SCH_Context* ctx, TaskNode* node, uint32_t delay) {
+    uint32_t latest = (delay + node->Slack < delay) ? 0xFFFFFFFFu : delay + node->Slack;
+    uint32_t target = delay;
+    TaskNode* current = *SCH_List_Of(ctx, node);
+    uint32_t accumulatedTime = 0;
+
+    if (node->Slack > 0) {
+        // 1. Existing release inside the window?
+        while (current != NULL) {
+            accumulatedTime += current->Delay;
+            if (accumulatedTime >= delay) {
+                break;
+            }
+            current = current->next;
+        }
+
+        if (current != NULL && accumulatedTime <= latest) {
+            target = accumulatedTime;
+            if (target != delay) {
+                ctx->WakeupsSaved++;
+            }
+        } else {
+            // 2. Aligned tick: CurrentTick + target is a multiple of 'align'
+            uint32_t align = 1;
+            while (align < 0x80000000u && (align << 1) - 1 <= node->Slack) {
+                align <<= 1;
+            }
+            target = delay + ((align - ((ctx->CurrentTick + delay) & (align - 1))) & (align - 1));
+        }
+    }
+
+    node->SlackUsed = target - delay;
+    SCH_Insert_Node(ctx, node, target);
+}
+
+/*----------------------------------------------------------------------------
+ * SCH_Release_Task() - Start a new round of a triggered task
+ *
+ * A parked task is moved to the head end of the context list with delay
+ * 0, so the running dispatch pass picks it up right away. A task that is
+ * still waiting to run from an earlier release is not released twice.
+ *---------------------------------------------------------------------------*/
+static void SCH_Release_Task(SCH_Context* ctx, TaskNode* node) {
+    SCH_TaskExt* ext = node->Ext;
+
+    ext->Pending = ext->Waits;
+    ext->Round++;                   // No edge has completed in the new round
+    if (ext->Trigger == SCH_TRIG_PARKED) {
+        TaskNode** link = &ctx->ParkedTasks;
+
+        while (*link != node) {
+            link = &(*link)->next;
+        }
+        *link = node->next;
+        ext->Trigger = SCH_TRIG_RELEASED;
+        SCH_Insert_Node(ctx, node, 0);
+    }
+}
+
+/*----------------------------------------------------------------------------
+ * SCH_Drop_Edges() - Free the dependency edges a task owns
+ *
+ * With 'detach', successors stop waiting for this task; one that was only
+ * waiting for this task in the current round is released. Without it the
+ * successors are assumed to be freed as well (context teardown).
+ *---------------------------------------------------------------------------*/
+static void SCH_Drop_Edges(SCH_Context* ctx, TaskNode* node, uint8_t detach) {
+    if (node->Ext == NULL) {
+        return;
+    }
+    while (node->Ext->Successors != NULL) {
+        SCH_Edge* edge = node->Ext->Successors;
+        SCH_TaskExt* to = edge->To->Ext;
+
+        node->Ext->Successors = edge->next;
+        if (detach) {
+            to->Waits--;
+            if (edge->Round != to->Round) {
+                // Still outstanding in this round
+                to->Pending--;
+                if (to->Pending == 0 && to->Waits > 0) {
+                    SCH_Release_Task(ctx, edge->To);
+                }
+            }
+        }
+        free(edge);
+    }
+}
+
+static void SCH_Free_Node(SCH_Context* ctx, TaskNode* node) {
+    SCH_Drop_Edges(ctx, node, 1);
+    if (node->Ext != NULL && node->Ext->Flags != NULL) {
+        TaskNode** link = &node->Ext->Flags->Waiters;
+
+        while (*link != node) {
+            link = &(*link)->Ext->NextWaiter;
+        }
+        *link = node->Ext->NextWaiter;
+    }
+    free(node->Ext);
+    free(node);
+}
 
 /*----------------------------------------------------------------------------
- * SCH_Init() - Initialize the scheduler
- * - Clears all tasks
+ * SCH_Ctx_Init() - Initialize a scheduler context
+ * - Starts with no tasks
  * - Resets tick counter
  * - Prepares for operation
+ *
+ * Only writes the context, so it may be called on uninitialized memory.
+ * A context must be initialized before first use. Tasks of a context that
+ * is in use are freed with SCH_Ctx_Deinit() before initializing it again.
  *---------------------------------------------------------------------------*/
-void SCH_Init(void) {
-    // Clear all existing tasks
-    while (g_TaskListHead != NULL) {
-        TaskNode* temp = g_TaskListHead;
-        g_TaskListHead = g_TaskListHead->next;
+void SCH_Ctx_Init(SCH_Context* ctx) {
+    ctx->TaskListHead = NULL;
+    ctx->CurrentTick = 0;
+    ctx->NextTaskID = 1;
+    ctx->ErrorCode = 0;
+    ctx->WakeupsSaved = 0;
+    ctx->ActiveMode = NULL;
+    ctx->PendingMode = NULL;
+    ctx->SwitchPending = 0;
+    ctx->OverloadTicks = 0;
+    ctx->OverloadBacklog = 0;
+    ctx->RecoverTicks = 0;
+    ctx->ShedBelow = 0;
+    ctx->Overloaded = 0;
+    ctx->LateTicks = 0;
+    ctx->OnTimeTicks = 0;
+    ctx->ShedCount = 0;
+    ctx->DeferCount = 0;
+    ctx->OverloadEpisodes = 0;
+    ctx->Dispatching = 0;
+    ctx->ReadCycles = NULL;
+    ctx->CyclesPerTick = 0;
+    ctx->BusyCycles = 0;
+    ctx->WindowStart = 0;
+    ctx->WindowTicks = 0;
+    ctx->TargetUtilization = 0;
+    ctx->Utilization = 0;
+    ctx->ElasticScale = SCH_ELASTIC_ONE;
+    ctx->Servers = NULL;
+    ctx->Partitions = NULL;
+    ctx->FrameTicks = 0;
+    ctx->FrameStart = ctx->CurrentTick;
+    ctx->ParkedTasks = NULL;
+    ctx->Topics = NULL;
+    ctx->Mailboxes = NULL;
+    ctx->FlagGroups = NULL;
+    ctx->WakeFlags = 0;
+    ctx->DispatchPass = 0;
+    ctx->VisitMark = 0;
+}
+
+/*----------------------------------------------------------------------------
+ * SCH_Ctx_Deinit() - Free all tasks of an initialized context
+ *
+ * Frees the scheduled and parked tasks and detaches the flag groups'
+ * waiters. Tasks of modes are freed with SCH_Mode_Clear(). The context
+ * keeps no tasks afterwards; call SCH_Ctx_Init() to use it again.
+ *---------------------------------------------------------------------------*/
+void SCH_Ctx_Deinit(SCH_Context* ctx) {
+    TaskNode* temp;
+
+    // Edges first, as they may point either way
+    for (temp = ctx->TaskListHead; temp != NULL; temp = temp->next) {
+        SCH_Drop_Edges(ctx, temp, 0);
+    }
+    for (temp = ctx->ParkedTasks; temp != NULL; temp = temp->next) {
+        SCH_Drop_Edges(ctx, temp, 0);
+    }
+    while (ctx->TaskListHead != NULL) {
+        temp = ctx->TaskListHead;
+        ctx->TaskListHead = ctx->TaskListHead->next;
+        free(temp->Ext);
+        free(temp);
+    }
+    while (ctx->ParkedTasks != NULL) {
+        temp = ctx->ParkedTasks;
+        ctx->ParkedTasks = ctx->ParkedTasks->next;
+        free(temp->Ext);
         free(temp);
     }
+    for (SCH_Flags* group = ctx->FlagGroups; group != NULL; group = group->next) {
+        group->Waiters = NULL;
+    }
+}
+
+/*----------------------------------------------------------------------------
+ * SCH_Apply_Mode() - Make a requested mode active (tick boundary only)
+ *
+ * Complexity: O(1) - the mode's list simply becomes the second active list
+ *---------------------------------------------------------------------------*/
+static void SCH_Apply_Mode(SCH_Context* ctx) {
+    if (ctx->SwitchPending) {
+        ctx->ActiveMode = ctx->PendingMode;
+        ctx->SwitchPending = 0;
+    }
+}
+
+/*----------------------------------------------------------------------------
+ * SCH_Track_Load() - Overload detection from dispatcher lateness
+ *
+ * A tick that finds the head task still due, or arrives while the
+ * dispatcher is still running released tasks, means the dispatcher is
+ * behind. Only the list heads are looked at, so the check stays O(1) and
+ * pending topic, mailbox or server work does not count as late.
+ * 'late' such ticks in a row enter overload (if OverloadTicks is set);
+ * RecoverTicks on-time ticks in a row leave it again.
+ *---------------------------------------------------------------------------*/
+static void SCH_Enter_Overload(SCH_Context* ctx) {
+    if (!ctx->Overloaded) {
+        ctx->Overloaded = 1;
+        ctx->OverloadEpisodes++;
+    }
+    ctx->OnTimeTicks = 0;
+}
+
+static void SCH_Track_Load(SCH_Context* ctx, uint32_t late, uint32_t onTime) {
+    if (ctx->ShedBelow == 0) {
+        return;                     // Load shedding disabled
+    }
 
-    g_TaskListHead = NULL;
-    g_CurrentTick = 0;
-    g_NextTaskID = 1;
-    g_ErrorCode = 0;
+    if (late > 0) {
+        ctx->LateTicks += late;
+        ctx->OnTimeTicks = 0;
+        if (ctx->OverloadTicks > 0 && ctx->LateTicks >= ctx->OverloadTicks) {
+            SCH_Enter_Overload(ctx);
+        }
+    } else {
+        ctx->LateTicks = 0;
+        ctx->OnTimeTicks += onTime;
+        if (ctx->Overloaded && ctx->OnTimeTicks >= ctx->RecoverTicks) {
+            ctx->Overloaded = 0;
+        }
+    }
+}
+
+/*
+ * Ticks until the head of the context list or of the active mode's list
+ * is due (SCH_NO_DEADLINE if both are empty). O(1), safe for the tick ISR.
+ */
+static uint32_t SCH_Ticks_To_Head(SCH_Context* ctx) {
+    uint32_t next = (ctx->TaskListHead != NULL) ? ctx->TaskListHead->Delay : SCH_NO_DEADLINE;
+
+    if (ctx->ActiveMode != NULL && ctx->ActiveMode->TaskListHead != NULL &&
+        ctx->ActiveMode->TaskListHead->Delay < next) {
+        next = ctx->ActiveMode->TaskListHead->Delay;
+    }
+    return next;
 }
 
 /*----------------------------------------------------------------------------
- * SCH_Update() - CRITICAL: Must be called from Timer ISR every 10ms
+ * SCH_Ctx_Update() - CRITICAL: Must be called from Timer ISR every 10ms
  *
  * Complexity: O(1) - Only updates head of sorted list!
  *
@@ -51,226 +398,1542 @@ void SCH_Init(void) {
  *
  * Called from: HAL_TIM_PeriodElapsedCallback()
  *---------------------------------------------------------------------------*/
-void SCH_Update(void) {
-    g_CurrentTick++;
+void SCH_Ctx_Update(SCH_Context* ctx) {
+    TaskNode* head = ctx->TaskListHead;
+
+    ctx->CurrentTick++;
+    SCH_Apply_Mode(ctx);
+    if (ctx->ShedBelow != 0) {
+        uint8_t late = ctx->Dispatching || SCH_Ticks_To_Head(ctx) == 0;
+        SCH_Track_Load(ctx, late, !late);
+    }
 
     // Only decrement the head task's delay (O(1) operation!)
     // Because list is sorted, only the first task needs checking
-    if (g_TaskListHead != NULL && g_TaskListHead->Delay > 0) {
-        g_TaskListHead->Delay--;
+    if (head != NULL && head->Delay > 0) {
+        head->Delay--;
+    }
+
+    // Same for the list of the active mode
+    if (ctx->ActiveMode != NULL) {
+        head = ctx->ActiveMode->TaskListHead;
+        if (head != NULL && head->Delay > 0) {
+            head->Delay--;
+        }
     }
 }
 
 /*----------------------------------------------------------------------------
- * SCH_Add_Task() - Add task to sorted list by insertion
+ * SCH_Ctx_Advance() - Advance time by several ticks at once
  *
- * Parameters:
- *   pFunction - Pointer to task function (void function(void))
- *   DELAY     - Initial delay in ticks (1 tick = 10ms)
- *   PERIOD    - Repeat period in ticks (0 = one-shot task)
+ * Exactly equivalent to calling SCH_Ctx_Update() 'ticks' times without
+ * dispatching in between. To keep dispatch order identical to tick-by-tick
+ * execution, never advance past SCH_Ctx_Get_Ticks_To_Next() before calling
+ * SCH_Ctx_Dispatch_Tasks().
  *
- * Returns: Task ID (> 0) on success, 0 on failure
+ * Complexity: O(1)
+ *---------------------------------------------------------------------------*/
+void SCH_Ctx_Advance(SCH_Context* ctx, uint32_t ticks) {
+    TaskNode* head = ctx->TaskListHead;
+
+    if (ticks == 0) {
+        return;
+    }
+    ctx->CurrentTick += ticks;
+    SCH_Apply_Mode(ctx);
+    if (ctx->ShedBelow != 0) {
+        uint32_t next = ctx->Dispatching ? 0 : SCH_Ticks_To_Head(ctx);
+        uint32_t late = (ticks > next) ? ticks - next : 0;
+        SCH_Track_Load(ctx, late, ticks - late);
+    }
+
+    // A due head (Delay == 0) does not age further, just as in SCH_Ctx_Update
+    if (head != NULL) {
+        head->Delay = (head->Delay > ticks) ? head->Delay - ticks : 0;
+    }
+    if (ctx->ActiveMode != NULL && (head = ctx->ActiveMode->TaskListHead) != NULL) {
+        head->Delay = (head->Delay > ticks) ? head->Delay - ticks : 0;
+    }
+}
+
+/* 1 if 'bits' satisfy the wait condition of a flag waiter */
+static uint8_t SCH_Flags_Match(TaskNode* w, uint32_t bits) {
+    uint32_t match = bits & w->Ext->FlagMask;
+
+    return (w->Ext->FlagOptions & SCH_FLAGS_ALL) ? (match == w->Ext->FlagMask) : (match != 0);
+}
+
+/*----------------------------------------------------------------------------
+ * SCH_Ctx_Get_Ticks_To_Next() - Ticks until the next task becomes due
  *
- * Example:
- *   SCH_Add_Task(Task_LED1, 0, 50);    // Run every 500ms, start immediately
- *   SCH_Add_Task(Task_LED2, 100, 100); // Run every 1s, start after 1s
+ * Returns: 0 if a task is already due, SCH_NO_DEADLINE if the list is empty
  *---------------------------------------------------------------------------*/
-uint32_t SCH_Add_Task(void (*pFunction)(void), uint32_t DELAY, uint32_t PERIOD) {
-    if (pFunction == NULL) {
-        g_ErrorCode = ERROR_SCH_TOO_MANY_TASKS;
-        return NO_TASK_ID;
+uint32_t SCH_Ctx_Get_Ticks_To_Next(SCH_Context* ctx) {
+    uint32_t next = SCH_Ticks_To_Head(ctx);
+
+    // Satisfied flag waiters are released now
+    for (SCH_Flags* group = ctx->FlagGroups; group != NULL && next > 0; group = group->next) {
+        uint32_t bits = group->Bits;
+
+        for (TaskNode* w = group->Waiters; w != NULL && bits != 0; w = w->Ext->NextWaiter) {
+            if ((w->Ext->Trigger == SCH_TRIG_PARKED || w->Ext->Trigger == SCH_TRIG_TIMED) &&
+                SCH_Flags_Match(w, bits)) {
+                next = 0;
+                break;
+            }
+        }
+    }
+
+    // Undelivered messages are delivered now
+    for (SCH_Topic* topic = ctx->Topics; topic != NULL && next > 0; topic = topic->next) {
+        if (topic->Seq != topic->Delivered) {
+            next = 0;
+        }
+    }
+
+    // Posted messages are consumed now
+    for (SCH_Mailbox* mbox = ctx->Mailboxes; mbox != NULL && next > 0; mbox = mbox->next) {
+        if (mbox->Head != mbox->Tail) {
+            next = 0;
+        }
+    }
+
+    // Servers with queued jobs run now, or at replenishment if out of budget
+    for (SCH_Server* srv = ctx->Servers; srv != NULL && next > 0; srv = srv->next) {
+        if (srv->Head != srv->Tail) {
+            uint32_t elapsed = ctx->CurrentTick - srv->PeriodStart;
+            uint32_t wait = (srv->Remaining > 0 || elapsed >= srv->Period) ? 0 : srv->Period - elapsed;
+            if (wait < next) {
+                next = wait;
+            }
+        }
+    }
+    return next;
+}
+
+/*----------------------------------------------------------------------------
+ * SCH_New_Node() - Allocate and initialize a task node (not linked)
+ *---------------------------------------------------------------------------*/
+static TaskNode* SCH_New_Node(SCH_Context* ctx, SCH_Mode* mode, void (*pFunction)(void), void (*pFunctionArg)(void*),
+                              void* arg, uint32_t PERIOD, uint32_t SLACK) {
+    if (pFunction == NULL && pFunctionArg == NULL) {
+        ctx->ErrorCode = ERROR_SCH_TOO_MANY_TASKS;
+        return NULL;
     }
 
     // Allocate new task node
     TaskNode* newTask = (TaskNode*)malloc(sizeof(TaskNode));
     if (newTask == NULL) {
-        g_ErrorCode = ERROR_SCH_TOO_MANY_TASKS;
-        return NO_TASK_ID;
+        ctx->ErrorCode = ERROR_SCH_TOO_MANY_TASKS;
+        return NULL;
     }
 
     // Initialize task data
     newTask->pTask = pFunction;
+    newTask->pTaskArg = pFunctionArg;
+    newTask->Arg = arg;
     newTask->Period = PERIOD;
-    newTask->TaskID = g_NextTaskID++;
+    newTask->Slack = (PERIOD > 0 && SLACK >= PERIOD) ? PERIOD - 1 : SLACK;
+    newTask->SlackUsed = 0;
+    newTask->TaskID = ctx->NextTaskID++;
+    newTask->Mode = mode;
+    newTask->Criticality = SCH_CRIT_HIGH;
+    newTask->MinPeriod = PERIOD;
+    newTask->MaxPeriod = 0;
+    newTask->Partition = NULL;
+    newTask->Ext = NULL;
     newTask->next = NULL;
 
-    /*
-     * Insert in sorted order using DELTA TIME technique
-     *
-     * Example: Tasks at 10ms, 25ms, 30ms stored as:
-     * Head -> [10] -> [15] -> [5] -> NULL
-     *         ^^^     ^^^     ^^^
-     *       10-0    25-10   30-25
-     */
-
-    if (g_TaskListHead == NULL || DELAY < g_TaskListHead->Delay) {
-        // Insert at head
-        newTask->Delay = DELAY;
-        if (g_TaskListHead != NULL) {
-            g_TaskListHead->Delay -= DELAY;
-        }
-        newTask->next = g_TaskListHead;
-        g_TaskListHead = newTask;
-    } else {
-        // Find insertion point
-        TaskNode* current = g_TaskListHead;
-        uint32_t accumulatedTime = g_TaskListHead->Delay;
+    return newTask;
+}
 
-        while (current->next != NULL &&
-               accumulatedTime + current->next->Delay <= DELAY) {
-            accumulatedTime += current->next->Delay;
-            current = current->next;
+/*
+ * Trigger state of a task, allocated on first use.
+ * Returns: NULL if out of memory
+ */
+static SCH_TaskExt* SCH_Ext_Of(SCH_Context* ctx, TaskNode* node) {
+    if (node->Ext == NULL) {
+        node->Ext = (SCH_TaskExt*)calloc(1, sizeof(SCH_TaskExt));
+        if (node->Ext == NULL) {
+            ctx->ErrorCode = ERROR_SCH_TOO_MANY_TASKS;
         }
+    }
+    return node->Ext;
+}
 
-        // Insert after current
-        newTask->Delay = DELAY - accumulatedTime;
-        newTask->next = current->next;
-
-        if (current->next != NULL) {
-            current->next->Delay -= newTask->Delay;
-        }
+/*----------------------------------------------------------------------------
+ * SCH_Add_Node() - Allocate a task node and link it into the list
+ *---------------------------------------------------------------------------*/
+static uint32_t SCH_Add_Node(SCH_Context* ctx, SCH_Mode* mode, void (*pFunction)(void), void (*pFunctionArg)(void*),
+                             void* arg, uint32_t DELAY, uint32_t PERIOD, uint32_t SLACK) {
+    TaskNode* newTask = SCH_New_Node(ctx, mode, pFunction, pFunctionArg, arg, PERIOD, SLACK);
 
-        current->next = newTask;
+    if (newTask == NULL) {
+        return NO_TASK_ID;
     }
+    SCH_Insert_Slack(ctx, newTask, DELAY);
 
     return newTask->TaskID;
 }
 
 /*----------------------------------------------------------------------------
- * SCH_Dispatch_Tasks() - Execute all tasks that are ready
+ * SCH_Ctx_Add_Task() - Add task to sorted list by insertion
  *
- * Must be called from main loop:
- *   while(1) {
- *       SCH_Dispatch_Tasks();
- *   }
+ * Parameters:
+ *   ctx       - Scheduler context
+ *   pFunction - Pointer to task function (void function(void))
+ *   DELAY     - Initial delay in ticks (1 tick = 10ms)
+ *   PERIOD    - Repeat period in ticks (0 = one-shot task)
  *
- * Complexity: O(k) where k = number of ready tasks
+ * Returns: Task ID (> 0) on success, 0 on failure
+ *
+ * Example:
+ *   SCH_Ctx_Add_Task(&ctx, Task_LED1, 0, 50);    // Every 500ms, start now
+ *   SCH_Ctx_Add_Task(&ctx, Task_LED2, 100, 100); // Every 1s, start after 1s
  *---------------------------------------------------------------------------*/
-void SCH_Dispatch_Tasks(void) {
-    // Process all tasks with Delay == 0
-    while (g_TaskListHead != NULL && g_TaskListHead->Delay == 0) {
-        TaskNode* taskToRun = g_TaskListHead;
+uint32_t SCH_Ctx_Add_Task(SCH_Context* ctx, void (*pFunction)(void), uint32_t DELAY, uint32_t PERIOD) {
+    return SCH_Add_Node(ctx, NULL, pFunction, NULL, NULL, DELAY, PERIOD, 0);
+}
 
-        // Remove from head
-        g_TaskListHead = g_TaskListHead->next;
+/*----------------------------------------------------------------------------
+ * SCH_Ctx_Add_Task_Arg() - Add a task that receives an argument
+ *
+ * Same as SCH_Ctx_Add_Task(), but pFunction is called as pFunction(arg).
+ * Lets one function serve many tasks (drivers, simulation models).
+ *---------------------------------------------------------------------------*/
+uint32_t SCH_Ctx_Add_Task_Arg(SCH_Context* ctx, void (*pFunction)(void*), void* arg, uint32_t DELAY, uint32_t PERIOD) {
+    return SCH_Add_Node(ctx, NULL, NULL, pFunction, arg, DELAY, PERIOD, 0);
+}
 
-        // Execute the task
-        if (taskToRun->pTask != NULL) {
-            (*taskToRun->pTask)();
-        }
+/*----------------------------------------------------------------------------
+ * SCH_Ctx_Add_Task_Slack() - Add a task that tolerates late release
+ *
+ * Like SCH_Ctx_Add_Task(), but every release may be delayed by up to
+ * SLACK ticks so it can share a wakeup with other tasks. Periodic tasks
+ * keep their nominal phase: lateness of one release is not carried into
+ * the next. SLACK is limited to PERIOD - 1.
+ *
+ * Example:
+ *   SCH_Ctx_Add_Task_Slack(&ctx, Task_Log, 0, 100, 10);  // Every 1s, up to 100ms late
+ *---------------------------------------------------------------------------*/
+uint32_t SCH_Ctx_Add_Task_Slack(SCH_Context* ctx, void (*pFunction)(void), uint32_t DELAY, uint32_t PERIOD,
+                                uint32_t SLACK) {
+    return SCH_Add_Node(ctx, NULL, pFunction, NULL, NULL, DELAY, PERIOD, SLACK);
+}
 
-        // Handle periodic tasks
-        if (taskToRun->Period > 0) {
-            // Reschedule periodic task
-            void (*savedFunc)(void) = taskToRun->pTask;
-            uint32_t savedPeriod = taskToRun->Period;
-            uint32_t savedID = taskToRun->TaskID;
-
-            free(taskToRun);
-
-            // Re-add with same ID and period
-            TaskNode* rescheduled = (TaskNode*)malloc(sizeof(TaskNode));
-            if (rescheduled != NULL) {
-                rescheduled->pTask = savedFunc;
-                rescheduled->Period = savedPeriod;
-                rescheduled->TaskID = savedID;
-                rescheduled->next = NULL;
-
-                // Re-insert in sorted order
-                if (g_TaskListHead == NULL || savedPeriod < g_TaskListHead->Delay) {
-                    rescheduled->Delay = savedPeriod;
-                    if (g_TaskListHead != NULL) {
-                        g_TaskListHead->Delay -= savedPeriod;
-                    }
-                    rescheduled->next = g_TaskListHead;
-                    g_TaskListHead = rescheduled;
-                } else {
-                    TaskNode* current = g_TaskListHead;
-                    uint32_t accum = g_TaskListHead->Delay;
-
-                    while (current->next != NULL &&
-                           accum + current->next->Delay <= savedPeriod) {
-                        accum += current->next->Delay;
-                        current = current->next;
-                    }
-
-                    rescheduled->Delay = savedPeriod - accum;
-                    rescheduled->next = current->next;
-
-                    if (current->next != NULL) {
-                        current->next->Delay -= rescheduled->Delay;
-                    }
-
-                    current->next = rescheduled;
-                }
-            }
-        } else {
-            // One-shot task, just free it
-            free(taskToRun);
-        }
+/*----------------------------------------------------------------------------
+ * SCH_Period_Of() - Period for the next release of a task
+ *
+ * Elastic tasks run at MinPeriod scaled by the context's ElasticScale,
+ * limited to MaxPeriod. Changing the scale thus re-times every elastic
+ * task at its next release without touching the list.
+ *---------------------------------------------------------------------------*/
+static uint32_t SCH_Period_Of(SCH_Context* ctx, TaskNode* node) {
+    uint32_t period;
+
+    if (node->MaxPeriod == 0 || ctx->ElasticScale == SCH_ELASTIC_ONE) {
+        return node->Period;
     }
+    period = (uint32_t)(((uint64_t)node->MinPeriod * ctx->ElasticScale) >> SCH_ELASTIC_SHIFT);
+    return (period > node->MaxPeriod) ? node->MaxPeriod : period;
 }
 
 /*----------------------------------------------------------------------------
- * SCH_Delete_Task() - Remove task by ID
+ * SCH_Adapt_Rates() - Elastic rate control, once per measurement window
  *
- * Parameters:
- *   taskID - ID returned by SCH_Add_Task()
+ * Utilization = task cycles / window cycles (per mille). Above target the
+ * elastic scale grows by utilization/target; below 90% of target it
+ * shrinks towards that band, never below 1.0. The band keeps the rates
+ * from oscillating around the target.
  *
- * Returns: 1 on success, 0 on failure
+ * Complexity: O(1) - only the scale changes
  *---------------------------------------------------------------------------*/
-uint8_t SCH_Delete_Task(uint32_t taskID) {
-    if (g_TaskListHead == NULL) {
-        g_ErrorCode = ERROR_SCH_CANNOT_DELETE_TASK;
-        return 0;
+static void SCH_Adapt_Rates(SCH_Context* ctx) {
+    uint32_t elapsed = ctx->CurrentTick - ctx->WindowStart;
+    uint64_t scale = ctx->ElasticScale;
+    uint32_t target = ctx->TargetUtilization;
+    uint32_t util;
+
+    if (elapsed < ctx->WindowTicks) {
+        return;
     }
+    util = (uint32_t)(((uint64_t)ctx->BusyCycles * 1000u) / ((uint64_t)elapsed * ctx->CyclesPerTick));
+    ctx->Utilization = util;
+    ctx->BusyCycles = 0;
+    ctx->WindowStart = ctx->CurrentTick;
 
-    TaskNode* current = g_TaskListHead;
-    TaskNode* previous = NULL;
+    if (util > target) {
+        scale = scale * util / target;
+    } else if (util * 10u < target * 9u) {
+        scale = scale * util * 10u / (target * 9u);
+    }
+    if (scale < SCH_ELASTIC_ONE) {
+        scale = SCH_ELASTIC_ONE;
+    } else if (scale > SCH_ELASTIC_MAX) {
+        scale = SCH_ELASTIC_MAX;
+    }
+    ctx->ElasticScale = (uint32_t)scale;
+}
 
-    while (current != NULL) {
-        if (current->TaskID == taskID) {
-            // Found the task to delete
-            if (previous == NULL) {
-                // Deleting head
-                g_TaskListHead = current->next;
-                if (g_TaskListHead != NULL) {
-                    g_TaskListHead->Delay += current->Delay;
-                }
-            } else {
-                // Deleting middle or end
-                previous->next = current->next;
-                if (current->next != NULL) {
-                    current->next->Delay += current->Delay;
-                }
-            }
+/*----------------------------------------------------------------------------
+ * SCH_Count_Due() - Number of tasks due now (dispatch backlog)
+ *
+ * Complexity: O(k) where k = number of ready tasks
+ *---------------------------------------------------------------------------*/
+static uint32_t SCH_Count_Due(SCH_Context* ctx) {
+    uint32_t count = 0;
+    TaskNode* node;
 
-            free(current);
-            return 1;
+    for (node = ctx->TaskListHead; node != NULL && node->Delay == 0; node = node->next) {
+        count++;
+    }
+    if (ctx->ActiveMode != NULL) {
+        for (node = ctx->ActiveMode->TaskListHead; node != NULL && node->Delay == 0; node = node->next) {
+            count++;
         }
-
-        previous = current;
-        current = current->next;
     }
-
-    g_ErrorCode = ERROR_SCH_TASK_NOT_FOUND;
-    return 0;
+    return count;
 }
 
 /*----------------------------------------------------------------------------
- * SCH_Get_Current_Time() - Get current time in milliseconds
- *
- * Returns: Time in ms (tick * 10ms)
+ * SCH_Roll_Frame() - Give all partitions their budget back each major frame
  *---------------------------------------------------------------------------*/
-uint32_t SCH_Get_Current_Time(void) {
-    return g_CurrentTick * 10;  // Convert ticks to milliseconds
+static void SCH_Roll_Frame(SCH_Context* ctx) {
+    uint32_t elapsed = ctx->CurrentTick - ctx->FrameStart;
+
+    if (elapsed < ctx->FrameTicks) {
+        return;
+    }
+    ctx->FrameStart += elapsed - elapsed % ctx->FrameTicks;
+    for (SCH_Partition* part = ctx->Partitions; part != NULL; part = part->next) {
+        if (part->Used > part->Budget) {
+            part->Overruns++;
+        }
+        part->Used = 0;
+    }
 }
 
 /*----------------------------------------------------------------------------
- * SCH_Get_Error_Code() - Get and clear error code
+ * SCH_Find_Task() - Scheduled task by ID (context list, then active mode)
  *---------------------------------------------------------------------------*/
-uint8_t SCH_Get_Error_Code(void) {
-    uint8_t error = g_ErrorCode;
-    g_ErrorCode = 0;
-    return error;
+static TaskNode* SCH_Find_Task(SCH_Context* ctx, uint32_t taskID) {
+    TaskNode* node;
+
+    for (node = ctx->TaskListHead; node != NULL; node = node->next) {
+        if (node->TaskID == taskID) {
+            return node;
+        }
+    }
+    if (ctx->ActiveMode != NULL) {
+        for (node = ctx->ActiveMode->TaskListHead; node != NULL; node = node->next) {
+            if (node->TaskID == taskID) {
+                return node;
+            }
+        }
+    }
+    for (node = ctx->ParkedTasks; node != NULL; node = node->next) {
+        if (node->TaskID == taskID) {
+            return node;
+        }
+    }
+    return NULL;
+}
+
+/*----------------------------------------------------------------------------
+ * SCH_Release_Successors() - Count a completion towards each successor
+ *
+ * Each edge counts once per round of its successor, so a predecessor that
+ * completes twice does not stand in for one that has not completed yet.
+ * A successor whose predecessors have all completed is released.
+ *---------------------------------------------------------------------------*/
+static void SCH_Release_Successors(SCH_Context* ctx, TaskNode* node) {
+    for (SCH_Edge* edge = node->Ext->Successors; edge != NULL; edge = edge->next) {
+        SCH_TaskExt* ext = edge->To->Ext;
+
+        if (edge->Round == ext->Round) {
+            continue;               // Already completed in this round
+        }
+        edge->Round = ext->Round;
+        if (ext->Pending > 1) {
+            ext->Pending--;
+            continue;
+        }
+        SCH_Release_Task(ctx, edge->To);
+    }
+}
+
+/*----------------------------------------------------------------------------
+ * SCH_Check_Flags() - Release the flag waiters whose condition holds
+ *
+ * All waiters of a group are checked against one snapshot of the flags,
+ * so several waiters can be released by the same bit before SCH_FLAGS_CLEAR
+ * takes it away. Released waiters go to the context list with delay 0.
+ * A waiter is released at most once per dispatch pass, so one whose flags
+ * stay set runs once per SCH_Ctx_Dispatch_Tasks() call, not endlessly.
+ *
+ * Returns: number of tasks released
+ *---------------------------------------------------------------------------*/
+static uint32_t SCH_Check_Flags(SCH_Context* ctx) {
+    uint32_t released = 0;
+
+    for (SCH_Flags* group = ctx->FlagGroups; group != NULL; group = group->next) {
+        uint32_t bits = group->Bits;
+        uint32_t clear = 0;
+
+        if (bits == 0) {
+            continue;
+        }
+        for (TaskNode* w = group->Waiters; w != NULL; w = w->Ext->NextWaiter) {
+            TaskNode** link;
+
+            if ((w->Ext->Trigger != SCH_TRIG_PARKED && w->Ext->Trigger != SCH_TRIG_TIMED) ||
+                w->Ext->FlagPass == ctx->DispatchPass || !SCH_Flags_Match(w, bits)) {
+                continue;
+            }
+
+            // Take it off the parked list or out of its timeout slot
+            if (w->Ext->Trigger == SCH_TRIG_PARKED) {
+                link = &ctx->ParkedTasks;
+            } else {
+                link = &ctx->TaskListHead;
+            }
+            while (*link != w) {
+                link = &(*link)->next;
+            }
+            *link = w->next;
+            if (w->Ext->Trigger == SCH_TRIG_TIMED && w->next != NULL) {
+                w->next->Delay += w->Delay;
+            }
+
+            w->Ext->WakeFlags = bits & w->Ext->FlagMask;
+            if (w->Ext->FlagOptions & SCH_FLAGS_CLEAR) {
+                clear |= w->Ext->WakeFlags;
+            }
+            w->Ext->Trigger = SCH_TRIG_RELEASED;
+            w->Ext->FlagPass = ctx->DispatchPass;
+            SCH_Insert_Node(ctx, w, 0);
+            released++;
+        }
+        if (clear != 0) {
+            SCH_Flags_Clear(group, clear);
+        }
+    }
+    return released;
+}
+
+/*----------------------------------------------------------------------------
+ * SCH_Run_Topics() - Deliver new messages to the subscribers of each topic
+ *
+ * Every message published since the last pass is handed to each
+ * subscriber in order. Messages already overwritten in the slot ring, or
+ * in the slot the next claim overwrites, are skipped in one step and
+ * counted as lost; subscribers see the gap in the sequence.
+ *---------------------------------------------------------------------------*/
+static void SCH_Run_Topics(SCH_Context* ctx) {
+    for (SCH_Topic* topic = ctx->Topics; topic != NULL; topic = topic->next) {
+        for (;;) {
+            uint32_t behind = topic->Seq - topic->Delivered;
+            uint32_t seq = topic->Delivered + 1;
+            const void* msg;
+
+            if (behind == 0) {
+                break;
+            }
+            if (behind >= topic->Depth) {
+                // Keep the newest Depth - 1: the oldest slot is claimable
+                uint32_t skip = behind - topic->Depth + 1u;
+
+                topic->Lost += skip;
+                topic->Delivered += skip;
+                continue;
+            }
+
+            msg = (const uint8_t*)topic->Slots + (seq % topic->Depth) * topic->SlotSize;
+            ctx->Dispatching = 1;
+            for (uint16_t i = 0; i < topic->NumSubscribers; i++) {
+                topic->Subscribers[i](msg, seq);
+            }
+            topic->Delivered = seq;
+        }
+    }
+}
+
+/*----------------------------------------------------------------------------
+ * SCH_Run_Mailboxes() - Hand posted messages to their consumers
+ *
+ * Each message is passed to the mailbox's consumer and its buffer goes
+ * back to the pool once the consumer returns.
+ *---------------------------------------------------------------------------*/
+static void SCH_Run_Mailboxes(SCH_Context* ctx) {
+    for (SCH_Mailbox* mbox = ctx->Mailboxes; mbox != NULL; mbox = mbox->next) {
+        while (mbox->Head != mbox->Tail) {
+            void* msg = mbox->Queue[mbox->Head];
+
+            ctx->Dispatching = 1;
+            mbox->Consumer(msg);
+            mbox->Head = (uint16_t)((mbox->Head + 1u) % mbox->Capacity);
+            mbox->Received++;
+            if (mbox->Pool != NULL) {
+                SCH_Pool_Release(mbox->Pool, msg);
+            }
+        }
+    }
+}
+
+/*----------------------------------------------------------------------------
+ * SCH_Run_Servers() - Serve queued aperiodic jobs within server budgets
+ *
+ * Runs after the due periodic tasks, so they always go first. A server
+ * gets Budget back every Period ticks; a job that overruns the rest of
+ * the budget is charged to the next period.
+ *---------------------------------------------------------------------------*/
+static void SCH_Run_Servers(SCH_Context* ctx) {
+    for (SCH_Server* srv = ctx->Servers; srv != NULL; srv = srv->next) {
+        uint32_t elapsed = ctx->CurrentTick - srv->PeriodStart;
+
+        // Replenish on the period grid
+        if (elapsed >= srv->Period) {
+            srv->PeriodStart += elapsed - elapsed % srv->Period;
+            srv->Remaining = (int32_t)srv->Budget + ((srv->Remaining < 0) ? srv->Remaining : 0);
+        }
+
+        while (srv->Head != srv->Tail && srv->Remaining > 0) {
+            SCH_Job* job = &srv->Queue[srv->Head];
+            uint32_t wait = ctx->CurrentTick - job->PostTick;
+            uint32_t start;
+
+            if (wait > srv->MaxWait) {
+                srv->MaxWait = wait;
+            }
+            ctx->Dispatching = 1;
+            start = (ctx->ReadCycles != NULL) ? ctx->ReadCycles() : 0;
+            job->Job(job->Arg);
+            srv->Head = (uint16_t)((srv->Head + 1u) % srv->Capacity);
+            srv->Served++;
+
+            // Budget in cycles with a cycle counter, else in jobs
+            if (ctx->ReadCycles != NULL) {
+                uint32_t used = ctx->ReadCycles() - start;
+                ctx->BusyCycles += used;
+                srv->Remaining -= (used > 0x7FFFFFFFu) ? 0x7FFFFFFF : (int32_t)used;
+            } else {
+                srv->Remaining--;
+            }
+        }
+    }
+}
+
+/*----------------------------------------------------------------------------
+ * SCH_Ctx_Dispatch_Tasks() - Execute all tasks that are ready
+ *
+ * Must be called from main loop:
+ *   while(1) {
+ *       SCH_Ctx_Dispatch_Tasks(&ctx);
+ *   }
+ *
+ * Complexity: O(k) where k = number of ready tasks
+ *---------------------------------------------------------------------------*/
+void SCH_Ctx_Dispatch_Tasks(SCH_Context* ctx) {
+    ctx->DispatchPass++;
+    if (ctx->OverloadBacklog > 0 && ctx->ShedBelow != 0 && SCH_Count_Due(ctx) >= ctx->OverloadBacklog) {
+        SCH_Enter_Overload(ctx);
+    }
+    if (ctx->TargetUtilization != 0) {
+        SCH_Adapt_Rates(ctx);
+    }
+    if (ctx->FrameTicks != 0) {
+        SCH_Roll_Frame(ctx);
+    }
+
+    // Process all tasks with Delay == 0, always-active tasks first
+    for (;;) {
+        TaskNode** list = &ctx->TaskListHead;
+        TaskNode* taskToRun;
+
+        if (*list == NULL || (*list)->Delay != 0) {
+            if (ctx->ActiveMode != NULL) {
+                list = &ctx->ActiveMode->TaskListHead;
+            }
+            if (*list == NULL || (*list)->Delay != 0) {
+                // Nothing due: flags set so far may still release waiters
+                if (ctx->FlagGroups != NULL && SCH_Check_Flags(ctx) > 0) {
+                    continue;
+                }
+                break;
+            }
+        }
+        taskToRun = *list;
+        ctx->Dispatching = 1;
+
+        // Remove from head
+        *list = taskToRun->next;
+        taskToRun->next = NULL;
+
+        // A flag waiter timing out: flags set by now win over the timeout,
+        // and either way this is its one release of the pass
+        if (taskToRun->Ext != NULL && taskToRun->Ext->Trigger == SCH_TRIG_TIMED) {
+            struct SCH_TaskExt* ext = taskToRun->Ext;
+            uint32_t bits = ext->Flags->Bits;
+
+            if (SCH_Flags_Match(taskToRun, bits)) {
+                ext->WakeFlags = bits & ext->FlagMask;
+                if (ext->FlagOptions & SCH_FLAGS_CLEAR) {
+                    SCH_Flags_Clear(ext->Flags, ext->WakeFlags);
+                }
+            }
+            ext->Trigger = SCH_TRIG_RELEASED;
+            ext->FlagPass = ctx->DispatchPass;
+        }
+
+        // Under overload, low-criticality releases are skipped (periodic)
+        // or deferred to the next tick (one-shot) instead of run
+        if (ctx->Overloaded && taskToRun->Criticality < ctx->ShedBelow) {
+            if (taskToRun->Period == 0) {
+                ctx->DeferCount++;
+                SCH_Insert_Node(ctx, taskToRun, 1);
+                continue;
+            }
+            ctx->ShedCount++;
+        } else if (taskToRun->Partition != NULL && ctx->FrameTicks != 0 &&
+                   taskToRun->Partition->Used >= taskToRun->Partition->Budget) {
+            // Partition out of budget: nothing of it runs until the next
+            // major frame (periodic releases are skipped)
+            taskToRun->Partition->Denied++;
+            if (taskToRun->Period == 0) {
+                // The tick ISR may have moved past the frame end meanwhile
+                uint32_t elapsed = ctx->CurrentTick - ctx->FrameStart;
+
+                SCH_Insert_Node(ctx, taskToRun, (elapsed < ctx->FrameTicks) ? ctx->FrameTicks - elapsed : 1);
+                continue;
+            }
+        } else {
+            // Execute the task, timed if a cycle counter is set
+            uint32_t start = (ctx->ReadCycles != NULL) ? ctx->ReadCycles() : 0;
+
+            if (taskToRun->Ext != NULL) {
+                ctx->WakeFlags = taskToRun->Ext->WakeFlags;
+                taskToRun->Ext->WakeFlags = 0;
+            }
+            if (taskToRun->pTask != NULL) {
+                (*taskToRun->pTask)();
+            } else {
+                (*taskToRun->pTaskArg)(taskToRun->Arg);
+            }
+            ctx->WakeFlags = 0;
+            if (ctx->ReadCycles != NULL) {
+                uint32_t used = ctx->ReadCycles() - start;
+
+                ctx->BusyCycles += used;
+                if (taskToRun->Partition != NULL) {
+                    taskToRun->Partition->Used += used;
+                }
+            } else if (taskToRun->Partition != NULL) {
+                taskToRun->Partition->Used++;
+            }
+            if (taskToRun->Ext != NULL && taskToRun->Ext->Successors != NULL) {
+                SCH_Release_Successors(ctx, taskToRun);
+            }
+        }
+
+        // Handle periodic tasks
+        if (taskToRun->Period > 0) {
+            // Reschedule periodic task, reusing its node (same ID and period)
+            uint32_t period = SCH_Period_Of(ctx, taskToRun);
+
+            if (taskToRun->Slack == 0) {
+                SCH_Insert_Node(ctx, taskToRun, period);
+            } else {
+                // Next nominal release, then place it within the slack again.
+                // An elastic period may have shrunk below this release's lateness.
+                uint32_t late = (taskToRun->SlackUsed < period) ? taskToRun->SlackUsed : period - 1;
+
+                SCH_Insert_Slack(ctx, taskToRun, period - late);
+            }
+        } else if (taskToRun->Ext != NULL && taskToRun->Ext->Flags != NULL && taskToRun->Ext->Timeout > 0) {
+            // Flag waiter, wait again with a fresh timeout
+            taskToRun->Ext->Trigger = SCH_TRIG_TIMED;
+            SCH_Insert_Node(ctx, taskToRun, taskToRun->Ext->Timeout);
+        } else if (SCH_TRIGGER_OF(taskToRun) != SCH_TRIG_NONE) {
+            // Triggered task, wait for the predecessors (or flags) again
+            taskToRun->Ext->Trigger = SCH_TRIG_PARKED;
+            taskToRun->next = ctx->ParkedTasks;
+            ctx->ParkedTasks = taskToRun;
+        } else {
+            // One-shot task, just free it
+            SCH_Free_Node(ctx, taskToRun);
+        }
+    }
+
+    if (ctx->Topics != NULL) {
+        SCH_Run_Topics(ctx);
+    }
+    if (ctx->Mailboxes != NULL) {
+        SCH_Run_Mailboxes(ctx);
+    }
+    if (ctx->Servers != NULL) {
+        SCH_Run_Servers(ctx);
+    }
+    ctx->Dispatching = 0;
+}
+
+/*----------------------------------------------------------------------------
+ * SCH_Unlink_Task() - Remove and free a task of one list by ID
+ *
+ * Returns: 1 if the task was in the list, 0 otherwise
+ *---------------------------------------------------------------------------*/
+static uint8_t SCH_Unlink_Task(SCH_Context* ctx, TaskNode** list, uint32_t taskID) {
+    TaskNode* current = *list;
+    TaskNode* previous = NULL;
+
+    while (current != NULL) {
+        if (current->TaskID == taskID) {
+            // Found the task to delete
+            if (previous == NULL) {
+                // Deleting head
+                *list = current->next;
+                if (*list != NULL) {
+                    (*list)->Delay += current->Delay;
+                }
+            } else {
+                // Deleting middle or end
+                previous->next = current->next;
+                if (current->next != NULL) {
+                    current->next->Delay += current->Delay;
+                }
+            }
+
+            SCH_Free_Node(ctx, current);
+            return 1;
+        }
+
+        previous = current;
+        current = current->next;
+    }
+    return 0;
+}
+
+/*----------------------------------------------------------------------------
+ * SCH_Ctx_Delete_Task() - Remove task by ID
+ *
+ * Parameters:
+ *   ctx    - Scheduler context
+ *   taskID - ID returned by SCH_Ctx_Add_Task()
+ *
+ * Searches the always-active tasks and those of the active mode; tasks of
+ * other modes are removed with SCH_Mode_Delete_Task().
+ *
+ * Returns: 1 on success, 0 on failure
+ *---------------------------------------------------------------------------*/
+uint8_t SCH_Ctx_Delete_Task(SCH_Context* ctx, uint32_t taskID) {
+    TaskNode* modeList = (ctx->ActiveMode != NULL) ? ctx->ActiveMode->TaskListHead : NULL;
+    TaskNode* node;
+
+    if (ctx->TaskListHead == NULL && modeList == NULL && ctx->ParkedTasks == NULL) {
+        ctx->ErrorCode = ERROR_SCH_CANNOT_DELETE_TASK;
+        return 0;
+    }
+
+    // Predecessors still point at a task with dependencies
+    node = SCH_Find_Task(ctx, taskID);
+    if (node != NULL && node->Ext != NULL && node->Ext->Waits > 0) {
+        ctx->ErrorCode = ERROR_SCH_CANNOT_DELETE_TASK;
+        return 0;
+    }
+
+    if (SCH_Unlink_Task(ctx, &ctx->TaskListHead, taskID) ||
+        (ctx->ActiveMode != NULL && SCH_Unlink_Task(ctx, &ctx->ActiveMode->TaskListHead, taskID)) ||
+        SCH_Unlink_Task(ctx, &ctx->ParkedTasks, taskID)) {
+        return 1;
+    }
+
+    ctx->ErrorCode = ERROR_SCH_TASK_NOT_FOUND;
+    return 0;
+}
+
+/*----------------------------------------------------------------------------
+ * Operating Modes - task sets prepared ahead of time
+ *
+ * Each mode owns a sorted list of its own tasks. At most one mode is
+ * active at a time; its list is scheduled alongside the context's list of
+ * always-active tasks, so switching is a pointer swap:
+ *
+ *   Context list:  [LED1] -> [Watchdog]          (every mode, never stops)
+ *   Mode NORMAL:   [LED2] -> [LED3]
+ *   Mode LOWPOWER: [LED5]
+ *
+ * Tasks common to several modes belong in the context list: they are not
+ * touched by a switch, so their phase is preserved exactly. Time stands
+ * still for an inactive mode; when it becomes active again its tasks
+ * continue with the delays they had left.
+ *
+ * A mode belongs to one context (task IDs come from that context).
+ *---------------------------------------------------------------------------*/
+void SCH_Mode_Init(SCH_Mode* mode, const char* name) {
+    mode->TaskListHead = NULL;
+    mode->Name = name;
+}
+
+/*
+ * Free all tasks of a mode. The mode must not be active or pending, and
+ * 'ctx' must still hold the successors of the mode's tasks.
+ */
+void SCH_Mode_Clear(SCH_Context* ctx, SCH_Mode* mode) {
+    while (mode->TaskListHead != NULL) {
+        TaskNode* temp = mode->TaskListHead;
+        mode->TaskListHead = temp->next;
+        SCH_Free_Node(ctx, temp);
+    }
+}
+
+/*----------------------------------------------------------------------------
+ * SCH_Mode_Add_Task() - Add a task that only runs while 'mode' is active
+ *
+ * DELAY counts ticks of active time of the mode, so tasks added while the
+ * mode is inactive start DELAY ticks after the mode is switched in.
+ *---------------------------------------------------------------------------*/
+uint32_t SCH_Mode_Add_Task(SCH_Context* ctx, SCH_Mode* mode, void (*pFunction)(void), uint32_t DELAY,
+                           uint32_t PERIOD) {
+    return SCH_Add_Node(ctx, mode, pFunction, NULL, NULL, DELAY, PERIOD, 0);
+}
+
+uint8_t SCH_Mode_Delete_Task(SCH_Context* ctx, SCH_Mode* mode, uint32_t taskID) {
+    if (SCH_Unlink_Task(ctx, &mode->TaskListHead, taskID)) {
+        return 1;
+    }
+    ctx->ErrorCode = ERROR_SCH_TASK_NOT_FOUND;
+    return 0;
+}
+
+/*----------------------------------------------------------------------------
+ * SCH_Ctx_Switch_Mode() - Request a mode change (NULL = no mode)
+ *
+ * Takes effect atomically at the next tick (SCH_Ctx_Update/Advance), so
+ * the dispatcher never sees a half-switched task set. Safe to call from a
+ * task; a later request before that tick replaces an earlier one.
+ *
+ * Complexity: O(1)
+ *---------------------------------------------------------------------------*/
+void SCH_Ctx_Switch_Mode(SCH_Context* ctx, SCH_Mode* mode) {
+    ctx->PendingMode = mode;
+    ctx->SwitchPending = 1;
+}
+
+SCH_Mode* SCH_Ctx_Get_Mode(SCH_Context* ctx) {
+    return ctx->ActiveMode;
+}
+
+/*----------------------------------------------------------------------------
+ * Load Shedding - keep critical tasks on time when the dispatcher falls behind
+ *
+ * Overload is entered when the due head has waited 'lateTicks' ticks in a
+ * row, or when 'backlog' tasks are due at the start of a dispatch (0
+ * disables either trigger). While overloaded, tasks with criticality below
+ * 'shedBelow' are not run: periodic releases are skipped (phase kept),
+ * one-shot tasks wait for the next tick. Overload ends after
+ * 'recoverTicks' ticks in a row on which the dispatcher kept up.
+ *
+ * Example: shed LOW and MEDIUM tasks after 3 late ticks, recover after 50:
+ *   SCH_Ctx_Set_Overload_Policy(&ctx, 3, 0, 50, SCH_CRIT_HIGH);
+ *
+ * shedBelow = 0 (default) disables shedding entirely.
+ *---------------------------------------------------------------------------*/
+void SCH_Ctx_Set_Overload_Policy(SCH_Context* ctx, uint32_t lateTicks, uint32_t backlog, uint32_t recoverTicks,
+                                 uint8_t shedBelow) {
+    ctx->OverloadTicks = lateTicks;
+    ctx->OverloadBacklog = backlog;
+    ctx->RecoverTicks = recoverTicks;
+    ctx->ShedBelow = shedBelow;
+    ctx->Overloaded = 0;
+    ctx->LateTicks = 0;
+    ctx->OnTimeTicks = 0;
+}
+
+/*
+ * Set the criticality of a scheduled task (new tasks are SCH_CRIT_HIGH).
+ * Returns: 1 on success, 0 if the task is not scheduled
+ */
+uint8_t SCH_Ctx_Set_Criticality(SCH_Context* ctx, uint32_t taskID, uint8_t level) {
+    TaskNode* node = SCH_Find_Task(ctx, taskID);
+
+    if (node == NULL) {
+        ctx->ErrorCode = ERROR_SCH_TASK_NOT_FOUND;
+        return 0;
+    }
+    node->Criticality = level;
+    return 1;
+}
+
+uint8_t SCH_Ctx_Is_Overloaded(SCH_Context* ctx) {
+    return ctx->Overloaded;
+}
+
+/* Releases skipped or deferred by load shedding since SCH_Ctx_Init() */
+uint32_t SCH_Ctx_Get_Shed_Count(SCH_Context* ctx) {
+    return ctx->ShedCount + ctx->DeferCount;
+}
+
+/*----------------------------------------------------------------------------
+ * SCH_Ctx_Set_Cycle_Counter() - Time task execution with a cycle counter
+ *
+ * read() returns a free-running 32-bit count (DWT->CYCCNT on target),
+ * cyclesPerTick is its rate per scheduler tick. Needed for utilization
+ * based features (elastic periods); costs two reads per task run.
+ * Pass NULL to stop measuring.
+ *
+ * Example (8 MHz HSI, 10ms tick):
+ *   SCH_Ctx_Set_Cycle_Counter(&ctx, Read_DWT, 80000);
+ *---------------------------------------------------------------------------*/
+void SCH_Ctx_Set_Cycle_Counter(SCH_Context* ctx, uint32_t (*read)(void), uint32_t cyclesPerTick) {
+    ctx->ReadCycles = read;
+    ctx->CyclesPerTick = cyclesPerTick;
+    ctx->BusyCycles = 0;
+    ctx->WindowStart = ctx->CurrentTick;
+}
+
+/*----------------------------------------------------------------------------
+ * Elastic Periods - adapt rates to load instead of dropping work
+ *
+ * An elastic task runs every MinPeriod ticks while utilization is within
+ * target. When the measured utilization exceeds the target, all elastic
+ * periods are stretched by the same factor (up to each task's MaxPeriod),
+ * and shrink back to MinPeriod as load drops. Non-elastic tasks keep
+ * their period.
+ *
+ * Example: LED task may slow from 0.5s to 2s, keep CPU load <= 70%:
+ *   SCH_Ctx_Set_Cycle_Counter(&ctx, Read_DWT, 80000);
+ *   SCH_Ctx_Set_Elastic(&ctx, id, 50, 200);
+ *   SCH_Ctx_Set_Utilization_Target(&ctx, 700, 100);
+ *---------------------------------------------------------------------------*/
+uint8_t SCH_Ctx_Set_Elastic(SCH_Context* ctx, uint32_t taskID, uint32_t minPeriod, uint32_t maxPeriod) {
+    TaskNode* node = SCH_Find_Task(ctx, taskID);
+
+    if (node == NULL || minPeriod == 0 || maxPeriod < minPeriod) {
+        ctx->ErrorCode = ERROR_SCH_TASK_NOT_FOUND;
+        return 0;
+    }
+    node->Period = minPeriod;
+    node->MinPeriod = minPeriod;
+    node->MaxPeriod = maxPeriod;
+    if (node->Slack >= minPeriod) {
+        node->Slack = minPeriod - 1;    // As for SCH_Ctx_Add_Task_Slack()
+    }
+    return 1;
+}
+
+/*
+ * Target utilization in per mille of a tick (0 = off) and the length of
+ * the measurement window in ticks. Requires SCH_Ctx_Set_Cycle_Counter().
+ */
+void SCH_Ctx_Set_Utilization_Target(SCH_Context* ctx, uint32_t permille, uint32_t windowTicks) {
+    ctx->TargetUtilization = (ctx->ReadCycles != NULL && ctx->CyclesPerTick != 0) ? permille : 0;
+    ctx->WindowTicks = (windowTicks > 0) ? windowTicks : 1;
+    ctx->ElasticScale = SCH_ELASTIC_ONE;
+}
+
+/* Utilization of the last window in per mille */
+uint32_t SCH_Ctx_Get_Utilization(SCH_Context* ctx) {
+    return ctx->Utilization;
+}
+
+/* Period the task will be rescheduled with after its next run */
+uint32_t SCH_Ctx_Get_Task_Period(SCH_Context* ctx, uint32_t taskID) {
+    TaskNode* node = SCH_Find_Task(ctx, taskID);
+
+    return (node != NULL) ? SCH_Period_Of(ctx, node) : 0;
+}
+
+/*----------------------------------------------------------------------------
+ * Aperiodic Servers - bounded service for bursty events
+ *
+ * A server owns a queue of aperiodic jobs (posted from ISRs or tasks) and
+ * a budget per replenishment period. Jobs run in the dispatcher right
+ * after the periodic tasks as long as budget is left; the rest waits for
+ * the next period. A burst can therefore take at most Budget per Period
+ * from the periodic tasks, and a job waits at most until the next
+ * replenishment once the queue ahead of it fits in the budget.
+ *
+ * Budget is in cycles if the context has a cycle counter
+ * (SCH_Ctx_Set_Cycle_Counter), otherwise in jobs.
+ *
+ * Example: at most 4 button jobs per 100ms:
+ *   static SCH_Job buttonJobs[16];
+ *   SCH_Server_Init(&buttonServer, buttonJobs, 16, 4, 10);
+ *   SCH_Ctx_Add_Server(&ctx, &buttonServer);
+ *   ...
+ *   SCH_Server_Post(&buttonServer, On_Button, NULL);    // From the EXTI ISR
+ *---------------------------------------------------------------------------*/
+void SCH_Server_Init(SCH_Server* srv, SCH_Job* queue, uint16_t capacity, uint32_t budget, uint32_t period) {
+    srv->Queue = queue;
+    srv->Capacity = capacity;
+    srv->Head = 0;
+    srv->Tail = 0;
+    srv->Budget = budget;
+    srv->Period = (period > 0) ? period : 1;
+    srv->Remaining = (int32_t)budget;
+    srv->PeriodStart = 0;
+    srv->Served = 0;
+    srv->Dropped = 0;
+    srv->MaxWait = 0;
+    srv->Ctx = NULL;
+    srv->next = NULL;
+}
+
+void SCH_Ctx_Add_Server(SCH_Context* ctx, SCH_Server* srv) {
+    srv->Ctx = ctx;
+    srv->PeriodStart = ctx->CurrentTick;
+    srv->next = ctx->Servers;
+    ctx->Servers = srv;
+}
+
+/*
+ * Queue a job on a server. Single producer: post from one ISR priority
+ * level or from tasks, not both.
+ * Returns: 1 if queued, 0 if the queue is full (job dropped)
+ */
+uint8_t SCH_Server_Post(SCH_Server* srv, void (*job)(void*), void* arg) {
+    uint16_t tail = srv->Tail;
+    uint16_t next = (uint16_t)((tail + 1u) % srv->Capacity);
+
+    if (next == srv->Head) {
+        srv->Dropped++;
+        return 0;
+    }
+    srv->Queue[tail].Job = job;
+    srv->Queue[tail].Arg = arg;
+    srv->Queue[tail].PostTick = (srv->Ctx != NULL) ? srv->Ctx->CurrentTick : 0;
+    srv->Tail = next;               // Publish after the job is written
+    return 1;
+}
+
+/*----------------------------------------------------------------------------
+ * Partitions - CPU budgets per task group and major frame
+ *
+ * Tasks assigned to a partition share its budget. Once a partition has
+ * used its budget in the current major frame, the dispatcher stops
+ * releasing its tasks until the next frame: periodic releases are
+ * skipped, one-shot tasks wait for the frame start. Tasks without a
+ * partition are never limited. A run is not interrupted, so a partition
+ * can overrun by at most one task run per frame (counted in Overruns).
+ *
+ * Budget is in cycles if the context has a cycle counter
+ * (SCH_Ctx_Set_Cycle_Counter), otherwise in task runs.
+ *
+ * Example: experimental module gets 10% of a 100ms frame (8 MHz):
+ *   SCH_Ctx_Set_Cycle_Counter(&ctx, Read_DWT, 80000);
+ *   SCH_Ctx_Set_Major_Frame(&ctx, 10);
+ *   SCH_Partition_Init(&experimental, "exp", 80000);
+ *   SCH_Ctx_Add_Partition(&ctx, &experimental);
+ *   SCH_Ctx_Set_Partition(&ctx, id, &experimental);
+ *---------------------------------------------------------------------------*/
+void SCH_Partition_Init(SCH_Partition* part, const char* name, uint32_t budget) {
+    part->Name = name;
+    part->Budget = budget;
+    part->Used = 0;
+    part->Denied = 0;
+    part->Overruns = 0;
+    part->next = NULL;
+}
+
+void SCH_Ctx_Add_Partition(SCH_Context* ctx, SCH_Partition* part) {
+    part->next = ctx->Partitions;
+    ctx->Partitions = part;
+}
+
+/* Major frame length in ticks (0 = budgets not enforced), restarts now */
+void SCH_Ctx_Set_Major_Frame(SCH_Context* ctx, uint32_t ticks) {
+    ctx->FrameTicks = ticks;
+    ctx->FrameStart = ctx->CurrentTick;
+    for (SCH_Partition* part = ctx->Partitions; part != NULL; part = part->next) {
+        part->Used = 0;
+    }
+}
+
+/* Assign a task to a partition (NULL = unpartitioned) */
+uint8_t SCH_Ctx_Set_Partition(SCH_Context* ctx, uint32_t taskID, SCH_Partition* part) {
+    TaskNode* node = SCH_Find_Task(ctx, taskID);
+
+    if (node == NULL) {
+        ctx->ErrorCode = ERROR_SCH_TASK_NOT_FOUND;
+        return 0;
+    }
+    node->Partition = part;
+    return 1;
+}
+
+/*----------------------------------------------------------------------------
+ * Task Chains - release tasks on completion of their predecessors
+ *
+ * A triggered task has no timing of its own. It is released when all of
+ * its predecessors have completed once since its last release, and runs
+ * in the same dispatch pass, so a pipeline needs no guessed offsets:
+ *
+ *   sample = SCH_Ctx_Add_Task(&ctx, Task_Sample, 0, 10);
+ *   filter = SCH_Ctx_Add_Triggered_Task(&ctx, Task_Filter);
+ *   publish = SCH_Ctx_Add_Triggered_Task(&ctx, Task_Publish);
+ *   SCH_Ctx_Add_Dependency(&ctx, sample, filter);
+ *   SCH_Ctx_Add_Dependency(&ctx, filter, publish);
+ *
+ * Any task can be a predecessor; only triggered tasks can be successors
+ * (flag tasks are released by their flags alone).
+ * A dependency that would close a cycle is rejected. Releases that are
+ * shed or denied by a partition do not count as completions.
+ *---------------------------------------------------------------------------*/
+uint32_t SCH_Ctx_Add_Triggered_Task(SCH_Context* ctx, void (*pFunction)(void)) {
+    TaskNode* newTask = SCH_New_Node(ctx, NULL, pFunction, NULL, NULL, 0, 0);
+
+    if (newTask == NULL) {
+        return NO_TASK_ID;
+    }
+    if (SCH_Ext_Of(ctx, newTask) == NULL) {
+        free(newTask);
+        return NO_TASK_ID;
+    }
+    newTask->Ext->Trigger = SCH_TRIG_PARKED;
+    newTask->next = ctx->ParkedTasks;
+    ctx->ParkedTasks = newTask;
+
+    return newTask->TaskID;
+}
+
+/*
+ * 1 if 'target' can be reached from 'from' along dependency edges. Tasks
+ * already searched carry 'mark', so every task is visited once: O(V + E).
+ */
+static uint8_t SCH_Reaches(TaskNode* from, TaskNode* target, uint32_t mark) {
+    if (from == target) {
+        return 1;
+    }
+    if (from->Ext == NULL || from->Ext->Visit == mark) {
+        return 0;
+    }
+    from->Ext->Visit = mark;
+    for (SCH_Edge* edge = from->Ext->Successors; edge != NULL; edge = edge->next) {
+        if (SCH_Reaches(edge->To, target, mark)) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/*
+ * Release task 'afterID' only after task 'beforeID' has completed.
+ * Returns: 1 on success, 0 if a task is missing, 'afterID' is not a
+ * triggered task (a flag task is not) or the dependency would create a cycle
+ */
+uint8_t SCH_Ctx_Add_Dependency(SCH_Context* ctx, uint32_t beforeID, uint32_t afterID) {
+    TaskNode* before = SCH_Find_Task(ctx, beforeID);
+    TaskNode* after = SCH_Find_Task(ctx, afterID);
+    SCH_Edge* edge;
+    SCH_Edge** link;
+
+    if (before == NULL || after == NULL || SCH_TRIGGER_OF(after) == SCH_TRIG_NONE || after->Ext->Flags != NULL) {
+        ctx->ErrorCode = ERROR_SCH_TASK_NOT_FOUND;
+        return 0;
+    }
+    if (++ctx->VisitMark == 0) {
+        ctx->VisitMark = 1;         // 0 is the mark of new extensions
+    }
+    if (SCH_Reaches(after, before, ctx->VisitMark)) {
+        ctx->ErrorCode = ERROR_SCH_DEPENDENCY_CYCLE;
+        return 0;
+    }
+
+    if (SCH_Ext_Of(ctx, before) == NULL) {
+        return 0;
+    }
+    edge = (SCH_Edge*)malloc(sizeof(SCH_Edge));
+    if (edge == NULL) {
+        ctx->ErrorCode = ERROR_SCH_TOO_MANY_TASKS;
+        return 0;
+    }
+    edge->To = after;
+    edge->Round = (uint16_t)(after->Ext->Round - 1u);   // Not completed yet
+    edge->next = NULL;
+
+    // Append, so successors are released in the order they were declared
+    link = &before->Ext->Successors;
+    while (*link != NULL) {
+        link = &(*link)->next;
+    }
+    *link = edge;
+    after->Ext->Waits++;
+    after->Ext->Pending++;
+    return 1;
+}
+
+/*----------------------------------------------------------------------------
+ * Topics - publish/subscribe without copies or allocation
+ *
+ * A topic is a ring of message slots plus a const table of subscribers,
+ * both defined at compile time with SCH_TOPIC_DEFINE. The publisher fills
+ * the slot returned by SCH_Topic_Claim() in place and commits it with
+ * SCH_Topic_Publish(), which only advances the sequence number. In the
+ * next dispatch pass every subscriber gets a pointer into the slot and
+ * the message's sequence number, so fan-out costs one call per
+ * subscriber and no copy.
+ *
+ * Depth bounds how many messages may be published between two dispatch
+ * passes before the oldest are lost. The claim for the next message
+ * reuses the oldest slot, possibly from an ISR while subscribers run, so
+ * only Depth - 1 messages are kept and Depth must be at least 2. Slots
+ * are reused, so a subscriber that keeps a message beyond its call must
+ * copy it. One publisher per topic (a task or one ISR priority level).
+ *
+ * Example:
+ *   static void Log_Temp(const void* msg, uint32_t seq);
+ *   static const SCH_Subscriber tempSubscribers[] = { Log_Temp, Show_Temp };
+ *   SCH_TOPIC_DEFINE(Topic_Temp, int16_t, 4, tempSubscribers);
+ *
+ *   SCH_Ctx_Add_Topic(&ctx, &Topic_Temp);
+ *   ...
+ *   *(int16_t*)SCH_Topic_Claim(&Topic_Temp) = Read_Temp();
+ *   SCH_Topic_Publish(&Topic_Temp);
+ *---------------------------------------------------------------------------*/
+void SCH_Ctx_Add_Topic(SCH_Context* ctx, SCH_Topic* topic) {
+    topic->Delivered = topic->Seq;
+    topic->next = ctx->Topics;
+    ctx->Topics = topic;
+}
+
+/* Slot the next published message goes to */
+void* SCH_Topic_Claim(SCH_Topic* topic) {
+    return (uint8_t*)topic->Slots + ((topic->Seq + 1) % topic->Depth) * topic->SlotSize;
+}
+
+/* Commit the claimed slot; returns its sequence number */
+uint32_t SCH_Topic_Publish(SCH_Topic* topic) {
+    topic->Seq = topic->Seq + 1;
+    return topic->Seq;
+}
+
+/* Latest message and its sequence number (NULL if none yet), for polling */
+const void* SCH_Topic_Latest(SCH_Topic* topic, uint32_t* seq) {
+    uint32_t latest = topic->Seq;
+
+    if (seq != NULL) {
+        *seq = latest;
+    }
+    if (latest == 0) {
+        return NULL;
+    }
+    return (const uint8_t*)topic->Slots + (latest % topic->Depth) * topic->SlotSize;
+}
+
+/*----------------------------------------------------------------------------
+ * Buffer Pools - fixed-size blocks from static storage
+ *
+ * The free blocks are kept in a ring of Count + 1 pointers, so one
+ * acquiring side (an ISR priority level or tasks) and one releasing side
+ * (tasks, including mailbox consumers) need no locking.
+ *
+ * Example: 8 blocks of 24 bytes:
+ *   static uint32_t sampleStorage[8 * 24 / 4];
+ *   static void* sampleFree[8 + 1];
+ *   SCH_Pool_Init(&samplePool, sampleStorage, 24, 8, sampleFree);
+ *---------------------------------------------------------------------------*/
+void SCH_Pool_Init(SCH_Pool* pool, void* storage, uint16_t blockSize, uint16_t count, void** freeRing) {
+    uint16_t size = (uint16_t)((blockSize + 3u) & ~3u);    // Keep blocks word aligned
+
+    pool->FreeRing = freeRing;
+    pool->Capacity = (uint16_t)(count + 1u);
+    pool->BlockSize = size;
+    pool->Head = 0;
+    pool->Tail = count;
+    pool->MinFree = count;
+    for (uint16_t i = 0; i < count; i++) {
+        freeRing[i] = (uint8_t*)storage + (uint32_t)i * size;
+    }
+}
+
+/* Take a free block; NULL if the pool is empty */
+void* SCH_Pool_Acquire(SCH_Pool* pool) {
+    uint16_t head = pool->Head;
+    void* block;
+    uint16_t left;
+
+    if (head == pool->Tail) {
+        return NULL;
+    }
+    block = pool->FreeRing[head];
+    pool->Head = (uint16_t)((head + 1u) % pool->Capacity);
+
+    left = SCH_Pool_Available(pool);
+    if (left < pool->MinFree) {
+        pool->MinFree = left;
+    }
+    return block;
+}
+
+/* Return a block taken with SCH_Pool_Acquire() */
+void SCH_Pool_Release(SCH_Pool* pool, void* block) {
+    uint16_t tail = pool->Tail;
+
+    pool->FreeRing[tail] = block;
+    pool->Tail = (uint16_t)((tail + 1u) % pool->Capacity);   // Publish after the write
+}
+
+uint16_t SCH_Pool_Available(SCH_Pool* pool) {
+    return (uint16_t)((pool->Tail + pool->Capacity - pool->Head) % pool->Capacity);
+}
+
+/*----------------------------------------------------------------------------
+ * Mailboxes - pass buffers between tasks without copying
+ *
+ * A producer acquires a buffer from the mailbox's pool, fills it in place
+ * and posts the pointer. The dispatcher calls the consumer with each
+ * message after the due tasks and then releases the buffer to the pool,
+ * so the consumer must not keep the pointer. Post from one ISR priority
+ * level or from tasks.
+ *
+ * Example:
+ *   static void* sampleQueue[8 + 1];
+ *   SCH_Mailbox_Init(&sampleBox, sampleQueue, 8 + 1, &samplePool, On_Sample);
+ *   SCH_Ctx_Add_Mailbox(&ctx, &sampleBox);
+ *   ...
+ *   Sample* s = SCH_Pool_Acquire(&samplePool);
+ *   if (s != NULL) {
+ *       s->value = Read_Value();
+ *       SCH_Mailbox_Post(&sampleBox, s);
+ *   }
+ *---------------------------------------------------------------------------*/
+void SCH_Mailbox_Init(SCH_Mailbox* mbox, void** queue, uint16_t capacity, SCH_Pool* pool,
+                      void (*consumer)(void* msg)) {
+    mbox->Queue = queue;
+    mbox->Capacity = capacity;
+    mbox->Head = 0;
+    mbox->Tail = 0;
+    mbox->Pool = pool;
+    mbox->Consumer = consumer;
+    mbox->Received = 0;
+    mbox->Dropped = 0;
+    mbox->next = NULL;
+}
+
+void SCH_Ctx_Add_Mailbox(SCH_Context* ctx, SCH_Mailbox* mbox) {
+    mbox->next = ctx->Mailboxes;
+    ctx->Mailboxes = mbox;
+}
+
+/*
+ * Post a filled buffer. Holds at most Capacity - 1 messages.
+ * Returns: 1 if posted, 0 if the mailbox is full (the buffer stays with
+ * the caller, who should release it)
+ */
+uint8_t SCH_Mailbox_Post(SCH_Mailbox* mbox, void* msg) {
+    uint16_t tail = mbox->Tail;
+    uint16_t next = (uint16_t)((tail + 1u) % mbox->Capacity);
+
+    if (next == mbox->Head) {
+        mbox->Dropped++;
+        return 0;
+    }
+    mbox->Queue[tail] = msg;
+    mbox->Tail = next;              // Publish after the message is written
+    return 1;
+}
+
+/*----------------------------------------------------------------------------
+ * Event Flags - release tasks when flags are set instead of polling
+ *
+ * A flag group holds 32 flags that ISRs and tasks set and clear
+ * atomically. A flag task waits for any (default) or all (SCH_FLAGS_ALL)
+ * flags of its mask and is released in the first dispatch pass that sees
+ * them, running once per release. With SCH_FLAGS_CLEAR the flags that
+ * released it are cleared; otherwise the task clears them itself, or runs
+ * again in every dispatch pass while they stay set. With a timeout the
+ * task also runs after that many ticks without its flags and
+ * SCH_Ctx_Get_Wake_Flags() then returns 0.
+ *
+ * Example: run On_Rx when the UART ISR signals, or every 1s as a fallback:
+ *   SCH_Flags_Init(&commFlags);
+ *   SCH_Ctx_Add_Flags(&ctx, &commFlags);
+ *   SCH_Ctx_Add_Flag_Task(&ctx, On_Rx, &commFlags, FLAG_RX, SCH_FLAGS_CLEAR, 100);
+ *   ...
+ *   SCH_Flags_Set(&commFlags, FLAG_RX);     // From the ISR
+ *---------------------------------------------------------------------------*/
+void SCH_Flags_Init(SCH_Flags* group) {
+    group->Bits = 0;
+    group->Waiters = NULL;
+    group->next = NULL;
+}
+
+void SCH_Ctx_Add_Flags(SCH_Context* ctx, SCH_Flags* group) {
+    group->next = ctx->FlagGroups;
+    ctx->FlagGroups = group;
+}
+
+uint32_t SCH_Flags_Set(SCH_Flags* group, uint32_t mask) {
+    return __atomic_or_fetch(&group->Bits, mask, __ATOMIC_SEQ_CST);
+}
+
+uint32_t SCH_Flags_Clear(SCH_Flags* group, uint32_t mask) {
+    return __atomic_and_fetch(&group->Bits, ~mask, __ATOMIC_SEQ_CST);
+}
+
+uint32_t SCH_Flags_Get(SCH_Flags* group) {
+    return group->Bits;
+}
+
+/*
+ * Add a task released by 'mask' of 'group' (options: SCH_FLAGS_*).
+ * timeout: ticks after which the task runs anyway, 0 = wait forever
+ * Returns: Task ID (> 0) on success, 0 on failure
+ */
+uint32_t SCH_Ctx_Add_Flag_Task(SCH_Context* ctx, void (*pFunction)(void), SCH_Flags* group, uint32_t mask,
+                               uint8_t options, uint32_t timeout) {
+    TaskNode* newTask;
+
+    if (group == NULL || mask == 0) {
+        ctx->ErrorCode = ERROR_SCH_TOO_MANY_TASKS;
+        return NO_TASK_ID;
+    }
+    newTask = SCH_New_Node(ctx, NULL, pFunction, NULL, NULL, 0, 0);
+    if (newTask == NULL) {
+        return NO_TASK_ID;
+    }
+    if (SCH_Ext_Of(ctx, newTask) == NULL) {
+        free(newTask);
+        return NO_TASK_ID;
+    }
+    newTask->Ext->Flags = group;
+    newTask->Ext->FlagMask = mask;
+    newTask->Ext->FlagOptions = options;
+    newTask->Ext->Timeout = timeout;
+    newTask->Ext->NextWaiter = group->Waiters;
+    group->Waiters = newTask;
+
+    if (timeout > 0) {
+        newTask->Ext->Trigger = SCH_TRIG_TIMED;
+        SCH_Insert_Node(ctx, newTask, timeout);
+    } else {
+        newTask->Ext->Trigger = SCH_TRIG_PARKED;
+        newTask->next = ctx->ParkedTasks;
+        ctx->ParkedTasks = newTask;
+    }
+    return newTask->TaskID;
+}
+
+/* Flags that released the running task, 0 after a timeout or for other tasks */
+uint32_t SCH_Ctx_Get_Wake_Flags(SCH_Context* ctx) {
+    return ctx->WakeFlags;
+}
+
+/*----------------------------------------------------------------------------
+ * SCH_Ctx_Get_Current_Time() - Get current time in milliseconds
+ *
+ * Returns: Time in ms (tick * 10ms)
+ *---------------------------------------------------------------------------*/
+uint32_t SCH_Ctx_Get_Current_Time(SCH_Context* ctx) {
+    return ctx->CurrentTick * 10;  // Convert ticks to milliseconds
+}
+
+/*----------------------------------------------------------------------------
+ * SCH_Ctx_Get_Current_Tick() - Get current time in ticks
+ *---------------------------------------------------------------------------*/
+uint32_t SCH_Ctx_Get_Current_Tick(SCH_Context* ctx) {
+    return ctx->CurrentTick;
+}
+
+/*----------------------------------------------------------------------------
+ * SCH_Ctx_Get_Wakeups_Saved() - Releases moved onto an existing wakeup
+ *
+ * Counts slack releases that joined a tick other tasks already wake up
+ * for, i.e. distinct wakeups avoided since SCH_Ctx_Init().
+ *---------------------------------------------------------------------------*/
+uint32_t SCH_Ctx_Get_Wakeups_Saved(SCH_Context* ctx) {
+    return ctx->WakeupsSaved;
+}
+
+/*----------------------------------------------------------------------------
+ * SCH_Ctx_Get_Error_Code() - Get and clear error code
+ *---------------------------------------------------------------------------*/
+uint8_t SCH_Ctx_Get_Error_Code(SCH_Context* ctx) {
+    uint8_t error = ctx->ErrorCode;
+    ctx->ErrorCode = 0;
+    return error;
+}
+
+/*----------------------------------------------------------------------------
+ * Default context API - thin wrappers kept for the single-scheduler case
+ *---------------------------------------------------------------------------*/
+void SCH_Init(void) {
+    SCH_Ctx_Deinit(&g_DefaultContext);
+    SCH_Ctx_Init(&g_DefaultContext);
+}
+
+void SCH_Update(void) {
+    SCH_Ctx_Update(&g_DefaultContext);
+}
+
+void SCH_Dispatch_Tasks(void) {
+    SCH_Ctx_Dispatch_Tasks(&g_DefaultContext);
+}
+
+uint32_t SCH_Add_Task(void (*pFunction)(void), uint32_t DELAY, uint32_t PERIOD) {
+    return SCH_Ctx_Add_Task(&g_DefaultContext, pFunction, DELAY, PERIOD);
+}
+
+uint32_t SCH_Add_Task_Slack(void (*pFunction)(void), uint32_t DELAY, uint32_t PERIOD, uint32_t SLACK) {
+    return SCH_Ctx_Add_Task_Slack(&g_DefaultContext, pFunction, DELAY, PERIOD, SLACK);
+}
+
+void SCH_Switch_Mode(SCH_Mode* mode) {
+    SCH_Ctx_Switch_Mode(&g_DefaultContext, mode);
+}
+
+uint8_t SCH_Set_Criticality(uint32_t taskID, uint8_t level) {
+    return SCH_Ctx_Set_Criticality(&g_DefaultContext, taskID, level);
+}
+
+void SCH_Add_Server(SCH_Server* srv) {
+    SCH_Ctx_Add_Server(&g_DefaultContext, srv);
+}
+
+uint8_t SCH_Set_Partition(uint32_t taskID, SCH_Partition* part) {
+    return SCH_Ctx_Set_Partition(&g_DefaultContext, taskID, part);
+}
+
+void SCH_Add_Flags(SCH_Flags* group) {
+    SCH_Ctx_Add_Flags(&g_DefaultContext, group);
+}
+
+uint32_t SCH_Add_Flag_Task(void (*pFunction)(void), SCH_Flags* group, uint32_t mask, uint8_t options,
+                           uint32_t timeout) {
+    return SCH_Ctx_Add_Flag_Task(&g_DefaultContext, pFunction, group, mask, options, timeout);
+}
+
+uint32_t SCH_Get_Wake_Flags(void) {
+    return SCH_Ctx_Get_Wake_Flags(&g_DefaultContext);
+}
+
+void SCH_Add_Mailbox(SCH_Mailbox* mbox) {
+    SCH_Ctx_Add_Mailbox(&g_DefaultContext, mbox);
+}
+
+void SCH_Add_Topic(SCH_Topic* topic) {
+    SCH_Ctx_Add_Topic(&g_DefaultContext, topic);
+}
+
+uint32_t SCH_Add_Triggered_Task(void (*pFunction)(void)) {
+    return SCH_Ctx_Add_Triggered_Task(&g_DefaultContext, pFunction);
+}
+
+uint8_t SCH_Add_Dependency(uint32_t beforeID, uint32_t afterID) {
+    return SCH_Ctx_Add_Dependency(&g_DefaultContext, beforeID, afterID);
+}
+
+uint8_t SCH_Delete_Task(uint32_t taskID) {
+    return SCH_Ctx_Delete_Task(&g_DefaultContext, taskID);
+}
+
+uint32_t SCH_Get_Current_Time(void) {
+    return SCH_Ctx_Get_Current_Time(&g_DefaultContext);
+}
+
+uint8_t SCH_Get_Error_Code(void) {
+    return SCH_Ctx_Get_Error_Code(&g_DefaultContext);
+}
+
+SCH_Context* SCH_Get_Default_Context(void) {
+    return &g_DefaultContext;
 }
@@ -0,0 +1,464 @@
+#include "scheduler_soa.h"
+#include <stddef.h>
+#include <stdlib.h>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#define SCH_SOA_FREE            0xFFFFFFFFu
+#define SCH_SOA_SLOT(id)        (((id) & SCH_SOA_MAX_TASKS) - 1)
+#define SCH_SOA_GEN(id)         ((id) >> SCH_SOA_SLOT_BITS)
+#define SCH_SOA_GEN_MASK        ((1u << (32 - SCH_SOA_SLOT_BITS)) - 1)
+#define SCH_SOA_PENDING         0x80000000u     // Generation flag: due, in batch
+#define SCH_SOA_PARKED          0x7FFFFFFFu     // Deadline offset while in batch
+
+/* Wrap-safe "a is at or before b" for virtual-time values */
+#define SCH_SOA_NOT_AFTER(a, b) ((int32_t)((a) - (b)) <= 0)
+
+/*----------------------------------------------------------------------------
+ * SCH_SoA_Carve() - Take the next 64-byte aligned array out of the buffer
+ *---------------------------------------------------------------------------*/
+static void* SCH_SoA_Carve(uint8_t** cursor, uint32_t bytes) {
+    void* p = *cursor;
+    *cursor += bytes;
+    return p;
+}
+
+/*----------------------------------------------------------------------------
+ * SCH_SoA_Init() - Initialize an SoA scheduler on caller memory
+ *
+ * mem must hold SCH_SOA_MEM_WORDS(capacity) words.
+ *---------------------------------------------------------------------------*/
+void SCH_SoA_Init(SCH_SoA_Context* ctx, uint32_t* mem, uint32_t capacity) {
+    uint32_t n = SCH_SOA_ROUND(capacity);
+    uint8_t* cursor = (uint8_t*)(((uintptr_t)mem + 63u) & ~(uintptr_t)63u);
+
+    if (capacity > SCH_SOA_MAX_TASKS) {
+        capacity = SCH_SOA_MAX_TASKS;
+    }
+
+    ctx->Deadline = SCH_SoA_Carve(&cursor, n * 4u);
+    ctx->Period = SCH_SoA_Carve(&cursor, n * 4u);
+    ctx->Seq = SCH_SoA_Carve(&cursor, n * 4u);
+    ctx->TaskID = SCH_SoA_Carve(&cursor, n * 4u);
+    ctx->Index = SCH_SoA_Carve(&cursor, n * 4u);
+    ctx->Generation = SCH_SoA_Carve(&cursor, n * 4u);
+    ctx->FreeSlots = SCH_SoA_Carve(&cursor, n * 4u);
+    ctx->Ready = SCH_SoA_Carve(&cursor, n * 8u);
+    ctx->pTask = SCH_SoA_Carve(&cursor, n * (uint32_t)sizeof(void*));
+    ctx->pTaskArg = SCH_SoA_Carve(&cursor, n * (uint32_t)sizeof(void*));
+    ctx->Arg = SCH_SoA_Carve(&cursor, n * (uint32_t)sizeof(void*));
+
+    for (uint32_t i = 0; i < capacity; i++) {
+        ctx->Index[i] = SCH_SOA_FREE;
+        ctx->Generation[i] = 0;
+        ctx->FreeSlots[i] = capacity - 1 - i;   // Hand out slot 0 first
+    }
+    ctx->NumFree = capacity;
+    ctx->Capacity = capacity;
+    ctx->Count = 0;
+    ctx->Now = 0;
+    ctx->NextDue = 0;
+    ctx->Pending = 0;
+    ctx->Running = NO_TASK_ID;
+    ctx->CurrentTick = 0;
+    ctx->NextSeq = 0;
+    ctx->ErrorCode = 0;
+}
+
+/*----------------------------------------------------------------------------
+ * SCH_SoA_Min_Deadline() - Earliest deadline over all packed tasks
+ *
+ * Works on deadlines relative to Now so the comparison survives wrap.
+ *---------------------------------------------------------------------------*/
+static uint32_t SCH_SoA_Min_Deadline(const SCH_SoA_Context* ctx) {
+    const uint32_t* d = ctx->Deadline;
+    uint32_t count = ctx->Count;
+    uint32_t now = ctx->Now;
+    int32_t best = INT32_MAX;
+    uint32_t i = 0;
+
+#if defined(__AVX2__)
+    __m256i vnow = _mm256_set1_epi32((int32_t)now);
+    __m256i vmin = _mm256_set1_epi32(INT32_MAX);
+    int32_t lanes[8];
+
+    for (; i + 8 <= count; i += 8) {
+        __m256i rel = _mm256_sub_epi32(_mm256_load_si256((const __m256i*)(d + i)), vnow);
+        vmin = _mm256_min_epi32(vmin, rel);
+    }
+    _mm256_storeu_si256((__m256i*)lanes, vmin);
+    for (uint32_t k = 0; k < 8; k++) {
+        best = lanes[k] < best ? lanes[k] : best;
+    }
+#else
+    for (; i + 4 <= count; i += 4) {
+        int32_t r0 = (int32_t)(d[i] - now);
+        int32_t r1 = (int32_t)(d[i + 1] - now);
+        int32_t r2 = (int32_t)(d[i + 2] - now);
+        int32_t r3 = (int32_t)(d[i + 3] - now);
+        int32_t m01 = r0 < r1 ? r0 : r1;
+        int32_t m23 = r2 < r3 ? r2 : r3;
+        int32_t m = m01 < m23 ? m01 : m23;
+        best = m < best ? m : best;
+    }
+#endif
+    for (; i < count; i++) {
+        int32_t r = (int32_t)(d[i] - now);
+        best = r < best ? r : best;
+    }
+    return now + (uint32_t)best;
+}
+
+/*----------------------------------------------------------------------------
+ * SCH_SoA_Collect_Due() - Find due tasks and the next deadline in one pass
+ *
+ * Writes (Seq, TaskID) pairs of due tasks to Ready and sets NextDue to the
+ * earliest deadline among the tasks that are not due.
+ *
+ * Returns: number of due tasks
+ *---------------------------------------------------------------------------*/
+static uint32_t SCH_SoA_Collect_Due(SCH_SoA_Context* ctx) {
+    const uint32_t* d = ctx->Deadline;
+    uint32_t* out = ctx->Ready;
+    uint32_t count = ctx->Count;
+    uint32_t now = ctx->Now;
+    int32_t best = INT32_MAX;
+    uint32_t found = 0;
+    uint32_t i = 0;
+
+#if defined(__AVX2__)
+    __m256i vnow = _mm256_set1_epi32((int32_t)now);
+    __m256i one = _mm256_set1_epi32(1);
+    __m256i vmin = _mm256_set1_epi32(INT32_MAX);
+    int32_t lanes[8];
+
+    for (; i + 8 <= count; i += 8) {
+        __m256i rel = _mm256_sub_epi32(_mm256_load_si256((const __m256i*)(d + i)), vnow);
+        __m256i due = _mm256_cmpgt_epi32(one, rel);
+        uint32_t mask = (uint32_t)_mm256_movemask_ps(_mm256_castsi256_ps(due));
+
+        vmin = _mm256_min_epi32(vmin, _mm256_or_si256(_mm256_andnot_si256(due, rel), _mm256_srli_epi32(due, 1)));
+#elif defined(__SSE2__)
+    __m128i vnow = _mm_set1_epi32((int32_t)now);
+    __m128i one = _mm_set1_epi32(1);
+    __m128i vmin = _mm_set1_epi32(INT32_MAX);
+    int32_t lanes[4];
+
+    for (; i + 4 <= count; i += 4) {
+        __m128i rel = _mm_sub_epi32(_mm_load_si128((const __m128i*)(d + i)), vnow);
+        __m128i due = _mm_cmpgt_epi32(one, rel);
+        __m128i cand = _mm_or_si128(_mm_andnot_si128(due, rel), _mm_srli_epi32(due, 1));
+        __m128i lt = _mm_cmpgt_epi32(vmin, cand);
+        uint32_t mask = (uint32_t)_mm_movemask_ps(_mm_castsi128_ps(due));
+
+        vmin = _mm_or_si128(_mm_and_si128(lt, cand), _mm_andnot_si128(lt, vmin));
+#endif
+#if defined(__AVX2__) || defined(__SSE2__)
+        // Due lanes were forced to INT32_MAX above, so only real work branches
+        while (mask != 0) {
+            uint32_t k = i + (uint32_t)__builtin_ctz(mask);
+            out[2 * found] = ctx->Seq[k];
+            out[2 * found + 1] = ctx->TaskID[k];
+            found++;
+            mask &= mask - 1;
+        }
+    }
+#if defined(__AVX2__)
+    _mm256_storeu_si256((__m256i*)lanes, vmin);
+#else
+    _mm_storeu_si128((__m128i*)lanes, vmin);
+#endif
+    for (uint32_t k = 0; k < sizeof(lanes) / sizeof(lanes[0]); k++) {
+        best = lanes[k] < best ? lanes[k] : best;
+    }
+#else
+    // Cortex-M: unrolled by four, one branch per group in the common case
+    for (; i + 4 <= count; i += 4) {
+        int32_t r0 = (int32_t)(d[i] - now);
+        int32_t r1 = (int32_t)(d[i + 1] - now);
+        int32_t r2 = (int32_t)(d[i + 2] - now);
+        int32_t r3 = (int32_t)(d[i + 3] - now);
+
+        if ((r0 <= 0) | (r1 <= 0) | (r2 <= 0) | (r3 <= 0)) {
+            for (uint32_t k = i; k < i + 4; k++) {
+                int32_t r = (int32_t)(d[k] - now);
+                if (r <= 0) {
+                    out[2 * found] = ctx->Seq[k];
+                    out[2 * found + 1] = ctx->TaskID[k];
+                    found++;
+                } else if (r < best) {
+                    best = r;
+                }
+            }
+        } else {
+            int32_t m01 = r0 < r1 ? r0 : r1;
+            int32_t m23 = r2 < r3 ? r2 : r3;
+            int32_t m = m01 < m23 ? m01 : m23;
+            best = m < best ? m : best;
+        }
+    }
+#endif
+    for (; i < count; i++) {
+        int32_t r = (int32_t)(d[i] - now);
+        if (r <= 0) {
+            out[2 * found] = ctx->Seq[i];
+            out[2 * found + 1] = ctx->TaskID[i];
+            found++;
+        } else if (r < best) {
+            best = r;
+        }
+    }
+
+    ctx->NextDue = now + (uint32_t)best;
+    return found;
+}
+
+static int SCH_SoA_Compare_Seq(const void* a, const void* b) {
+    int32_t diff = (int32_t)(*(const uint32_t*)a - *(const uint32_t*)b);
+    return (diff > 0) - (diff < 0);
+}
+
+/* Order due tasks by insertion, as the delta list does for equal deadlines */
+static void SCH_SoA_Sort_Ready(uint32_t* ready, uint32_t n) {
+    if (n > 16) {
+        qsort(ready, n, 2 * sizeof(uint32_t), SCH_SoA_Compare_Seq);
+        return;
+    }
+    for (uint32_t i = 1; i < n; i++) {
+        uint32_t seq = ready[2 * i], id = ready[2 * i + 1];
+        uint32_t j = i;
+
+        while (j > 0 && (int32_t)(ready[2 * (j - 1)] - seq) > 0) {
+            ready[2 * j] = ready[2 * (j - 1)];
+            ready[2 * j + 1] = ready[2 * (j - 1) + 1];
+            j--;
+        }
+        ready[2 * j] = seq;
+        ready[2 * j + 1] = id;
+    }
+}
+
+/*----------------------------------------------------------------------------
+ * SCH_SoA_Lookup() - Packed index of a task, SCH_SOA_FREE if ID is stale
+ *---------------------------------------------------------------------------*/
+static uint32_t SCH_SoA_Lookup(const SCH_SoA_Context* ctx, uint32_t taskID) {
+    uint32_t slot = SCH_SOA_SLOT(taskID);
+
+    if (taskID == NO_TASK_ID || slot >= ctx->Capacity ||
+        (ctx->Generation[slot] & SCH_SOA_GEN_MASK) != SCH_SOA_GEN(taskID)) {
+        return SCH_SOA_FREE;
+    }
+    return ctx->Index[slot];
+}
+
+/*----------------------------------------------------------------------------
+ * SCH_SoA_Remove() - Swap-remove the task at packed index 'idx'
+ *---------------------------------------------------------------------------*/
+static void SCH_SoA_Remove(SCH_SoA_Context* ctx, uint32_t idx) {
+    uint32_t slot = SCH_SOA_SLOT(ctx->TaskID[idx]);
+    uint32_t last = --ctx->Count;
+
+    if (idx != last) {
+        ctx->Deadline[idx] = ctx->Deadline[last];
+        ctx->Period[idx] = ctx->Period[last];
+        ctx->Seq[idx] = ctx->Seq[last];
+        ctx->TaskID[idx] = ctx->TaskID[last];
+        ctx->pTask[idx] = ctx->pTask[last];
+        ctx->pTaskArg[idx] = ctx->pTaskArg[last];
+        ctx->Arg[idx] = ctx->Arg[last];
+        ctx->Index[SCH_SOA_SLOT(ctx->TaskID[idx])] = idx;
+    }
+
+    if (ctx->Generation[slot] & SCH_SOA_PENDING) {
+        ctx->Pending--;
+    }
+    ctx->Index[slot] = SCH_SOA_FREE;
+    ctx->Generation[slot] = (ctx->Generation[slot] + 1) & SCH_SOA_GEN_MASK;
+    ctx->FreeSlots[ctx->NumFree++] = slot;
+}
+
+static uint32_t SCH_SoA_Add(SCH_SoA_Context* ctx, void (*pFunction)(void), void (*pFunctionArg)(void*),
+                            void* arg, uint32_t DELAY, uint32_t PERIOD) {
+    uint32_t slot, idx, deadline;
+
+    if ((pFunction == NULL && pFunctionArg == NULL) || ctx->NumFree == 0) {
+        ctx->ErrorCode = ERROR_SCH_TOO_MANY_TASKS;
+        return NO_TASK_ID;
+    }
+
+    slot = ctx->FreeSlots[--ctx->NumFree];
+    idx = ctx->Count++;
+    deadline = ctx->Now + DELAY;
+
+    ctx->Deadline[idx] = deadline;
+    ctx->Period[idx] = PERIOD;
+    ctx->Seq[idx] = ctx->NextSeq++;
+    ctx->TaskID[idx] = (ctx->Generation[slot] << SCH_SOA_SLOT_BITS) | (slot + 1);
+    ctx->pTask[idx] = pFunction;
+    ctx->pTaskArg[idx] = pFunctionArg;
+    ctx->Arg[idx] = arg;
+    ctx->Index[slot] = idx;
+
+    if (idx == 0 || (int32_t)(deadline - ctx->NextDue) < 0) {
+        ctx->NextDue = deadline;
+    }
+    return ctx->TaskID[idx];
+}
+
+/*----------------------------------------------------------------------------
+ * SCH_SoA_Add_Task() / SCH_SoA_Add_Task_Arg() - Add a task in O(1)
+ *
+ * Same parameters and return value as SCH_Ctx_Add_Task().
+ *---------------------------------------------------------------------------*/
+uint32_t SCH_SoA_Add_Task(SCH_SoA_Context* ctx, void (*pFunction)(void), uint32_t DELAY, uint32_t PERIOD) {
+    return SCH_SoA_Add(ctx, pFunction, NULL, NULL, DELAY, PERIOD);
+}
+
+uint32_t SCH_SoA_Add_Task_Arg(SCH_SoA_Context* ctx, void (*pFunction)(void*), void* arg, uint32_t DELAY, uint32_t PERIOD) {
+    return SCH_SoA_Add(ctx, NULL, pFunction, arg, DELAY, PERIOD);
+}
+
+/*----------------------------------------------------------------------------
+ * SCH_SoA_Delete_Task() - Remove task by ID
+ *
+ * O(1), plus one deadline scan when the earliest task is removed.
+ *---------------------------------------------------------------------------*/
+uint8_t SCH_SoA_Delete_Task(SCH_SoA_Context* ctx, uint32_t taskID) {
+    uint32_t idx;
+
+    if (ctx->Count == 0) {
+        ctx->ErrorCode = ERROR_SCH_CANNOT_DELETE_TASK;
+        return 0;
+    }
+
+    // As in scheduler.c, a running task is off the list and cannot be found
+    idx = SCH_SoA_Lookup(ctx, taskID);
+    if (idx == SCH_SOA_FREE || taskID == ctx->Running) {
+        ctx->ErrorCode = ERROR_SCH_TASK_NOT_FOUND;
+        return 0;
+    }
+
+    uint32_t deadline = ctx->Deadline[idx];
+    SCH_SoA_Remove(ctx, idx);
+    if (ctx->Count > 0 && deadline == ctx->NextDue) {
+        ctx->NextDue = SCH_SoA_Min_Deadline(ctx);
+    }
+    return 1;
+}
+
+/*----------------------------------------------------------------------------
+ * SCH_SoA_Update() - Timer tick, O(1)
+ *---------------------------------------------------------------------------*/
+void SCH_SoA_Update(SCH_SoA_Context* ctx) {
+    ctx->CurrentTick++;
+
+    // Virtual time stands still while a task is due, like the delta list head
+    if (SCH_SoA_Get_Ticks_To_Next(ctx) != 0) {
+        ctx->Now++;
+    }
+}
+
+/*----------------------------------------------------------------------------
+ * SCH_SoA_Advance() - Same as 'ticks' calls of SCH_SoA_Update(), O(1)
+ *---------------------------------------------------------------------------*/
+void SCH_SoA_Advance(SCH_SoA_Context* ctx, uint32_t ticks) {
+    ctx->CurrentTick += ticks;
+
+    if (ctx->Count > 0) {
+        uint32_t left = SCH_SoA_Get_Ticks_To_Next(ctx);
+        ctx->Now += ticks < left ? ticks : left;
+    }
+}
+
+/*----------------------------------------------------------------------------
+ * SCH_SoA_Dispatch_Tasks() - Execute all tasks that are ready
+ *
+ * Due tasks are collected as one batch, parked out of the deadline array
+ * and run in insertion order. Each one is taken off the batch before it
+ * runs and rescheduled after it returns, exactly like the list head.
+ *
+ * Complexity: O(1) when nothing is due, otherwise one vector scan per batch
+ * plus O(k log k) ordering of the k due tasks.
+ *---------------------------------------------------------------------------*/
+void SCH_SoA_Dispatch_Tasks(SCH_SoA_Context* ctx) {
+    while (ctx->Count > 0 && SCH_SOA_NOT_AFTER(ctx->NextDue, ctx->Now)) {
+        uint32_t found = SCH_SoA_Collect_Due(ctx);
+
+        SCH_SoA_Sort_Ready(ctx->Ready, found);
+
+        for (uint32_t r = 0; r < found; r++) {
+            uint32_t slot = SCH_SOA_SLOT(ctx->Ready[2 * r + 1]);
+            ctx->Deadline[ctx->Index[slot]] = ctx->Now + SCH_SOA_PARKED;
+            ctx->Generation[slot] |= SCH_SOA_PENDING;
+        }
+        ctx->Pending = found;
+
+        for (uint32_t r = 0; r < found; r++) {
+            uint32_t id = ctx->Ready[2 * r + 1];
+            uint32_t slot = SCH_SOA_SLOT(id);
+            uint32_t idx = SCH_SoA_Lookup(ctx, id);
+
+            // Deleted by an earlier task of this batch
+            if (idx == SCH_SOA_FREE) {
+                continue;
+            }
+
+            // Remove from head
+            ctx->Generation[slot] &= ~SCH_SOA_PENDING;
+            ctx->Pending--;
+            ctx->Running = id;
+
+            // Execute the task
+            if (ctx->pTask[idx] != NULL) {
+                (*ctx->pTask[idx])();
+            } else {
+                (*ctx->pTaskArg[idx])(ctx->Arg[idx]);
+            }
+
+            ctx->Running = NO_TASK_ID;
+            idx = ctx->Index[slot];     // Other tasks may have moved it
+
+            if (ctx->Period[idx] > 0) {
+                uint32_t deadline = ctx->Now + ctx->Period[idx];
+
+                ctx->Deadline[idx] = deadline;
+                ctx->Seq[idx] = ctx->NextSeq++;
+                if ((int32_t)(deadline - ctx->NextDue) < 0) {
+                    ctx->NextDue = deadline;
+                }
+            } else {
+                SCH_SoA_Remove(ctx, idx);
+            }
+        }
+    }
+}
+
+/*----------------------------------------------------------------------------
+ * SCH_SoA_Get_Ticks_To_Next() - Ticks until the next task becomes due
+ *---------------------------------------------------------------------------*/
+uint32_t SCH_SoA_Get_Ticks_To_Next(SCH_SoA_Context* ctx) {
+    if (ctx->Pending > 0) {
+        return 0;
+    }
+    if (ctx->Count == 0) {
+        return SCH_NO_DEADLINE;
+    }
+    if (SCH_SOA_NOT_AFTER(ctx->NextDue, ctx->Now)) {
+        return 0;
+    }
+    return ctx->NextDue - ctx->Now;
+}
+
+uint32_t SCH_SoA_Get_Current_Tick(SCH_SoA_Context* ctx) {
+    return ctx->CurrentTick;
+}
+
+uint8_t SCH_SoA_Get_Error_Code(SCH_SoA_Context* ctx) {
+    uint8_t error = ctx->ErrorCode;
+    ctx->ErrorCode = 0;
+    return error;
+}
@@ -23,6 +23,8 @@
 #include "stm32f1xx_it.h"
 /* Private includes ----------------------------------------------------------*/
 /* USER CODE BEGIN Includes */
+#include "led_bam.h"
+#include "adc_stream.h"
 /* USER CODE END Includes */
 
 /* Private typedef -----------------------------------------------------------*/
@@ -214,6 +216,25 @@ void TIM2_IRQHandler(void)
 }
 
 /* USER CODE BEGIN 1 */
+#ifdef LED_DRIVER_BAM
+/**
+  * @brief This function handles TIM3 global interrupt (LED bit planes).
+  */
+void TIM3_IRQHandler(void)
+{
+  LED_BAM_IRQHandler();
+}
+#endif
+
+#ifdef ADC_STREAM_ENABLE
+/**
+  * @brief This function handles DMA1 channel1 global interrupt (ADC1 halves).
+  */
+void DMA1_Channel1_IRQHandler(void)
+{
+  ADC_Stream_DMA_IRQHandler();
+}
+#endif
 
 /* USER CODE END 1 */
 /************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
@@ -0,0 +1,65 @@
+/*
+ * port_linux.h
+ *
+ * Linux runtime port: runs the unchanged scheduler.c and application tasks
+ * as a soft real-time event loop.
+ *
+ * - Periodic mode: a timerfd fires every tick and SCH_Ctx_Update() is
+ *   called once per expiration, like the TIM2 interrupt on target.
+ * - Tickless mode: the timerfd is armed for the next deadline only (on an
+ *   absolute timeline, so it does not drift) and elapsed ticks are applied
+ *   with SCH_Ctx_Advance().
+ * - File descriptors are watched with epoll; readiness queues the handler
+ *   as a one-shot scheduler task, so it runs in dispatch order with the
+ *   timed tasks. Watches are one-shot and re-armed after the handler ran.
+ * - GPIO writes of the tasks go to a pluggable output backend.
+ */
+
+#ifndef HOST_PORT_LINUX_H_
+#define HOST_PORT_LINUX_H_
+
+#include <stdint.h>
+#include "sim.h"
+
+#define PORT_MAX_WATCHES    16
+
+typedef void (*PORT_Fd_Handler)(int fd, uint32_t events, void* arg);
+
+typedef struct PORT_Linux PORT_Linux;
+
+typedef struct {
+    PORT_Linux* Port;
+    int Fd;                         // -1 when unused
+    uint32_t Events;                // EPOLLIN, EPOLLOUT, ...
+    uint32_t Ready;                 // Events reported by epoll
+    uint8_t Queued;                 // Handler task waiting for dispatch
+    PORT_Fd_Handler Handler;
+    void* Arg;
+} PORT_Watch;
+
+struct PORT_Linux {
+    SIM_Sim Device;                 // Scheduler context and GPIO registers
+    int EpollFd;
+    int TimerFd;
+    uint32_t TickMs;
+    uint8_t Tickless;
+    volatile int Stop;
+    uint64_t Start_ns;              // CLOCK_MONOTONIC at tick 0
+    uint64_t Overruns;              // Ticks applied late in one batch
+    PORT_Watch Watches[PORT_MAX_WATCHES];
+};
+
+/* Output backends for PORT_Linux::Device.OnGPIO */
+void PORT_GPIO_Log(SIM_Sim* sim, uint8_t port, uint16_t changed, uint16_t odr);
+void PORT_GPIO_Sysfs(SIM_Sim* sim, uint8_t port, uint16_t changed, uint16_t odr);
+int PORT_GPIO_Sysfs_Map(uint8_t port, uint8_t pin, int linuxGpio);
+
+int PORT_Linux_Init(PORT_Linux* port, uint32_t tickMs, uint8_t tickless);
+SCH_Context* PORT_Linux_Context(PORT_Linux* port);
+int PORT_Linux_Watch_Fd(PORT_Linux* port, int fd, uint32_t events, PORT_Fd_Handler handler, void* arg);
+int PORT_Linux_Unwatch_Fd(PORT_Linux* port, int fd);
+int PORT_Linux_Run(PORT_Linux* port);
+void PORT_Linux_Stop(PORT_Linux* port);
+void PORT_Linux_Close(PORT_Linux* port);
+
+#endif /* HOST_PORT_LINUX_H_ */
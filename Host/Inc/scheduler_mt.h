@@ -0,0 +1,100 @@
+/*
+ * scheduler_mt.h
+ *
+ * Multi-threaded scheduler variant for the Linux port.
+ *
+ * One timer thread owns an ordinary SCH_Context and is the only thread
+ * that ever touches the task list, so timer bookkeeping needs no locks.
+ * Other threads add and delete tasks by pushing commands onto a lock-free
+ * stack that the timer thread drains once per tick. Each job carries its
+ * own add and delete record, so a delete can follow the add before the
+ * timer thread has seen either.
+ *
+ * When a task becomes due the timer thread does not run it: it hands the
+ * job to the queue of the job's home worker and moves on, so the timer
+ * path never waits for a long-running task. Workers run their own queue
+ * first and steal from the others when it is empty. A periodic job that
+ * is still running when it is released again is skipped and counted,
+ * never run twice concurrently.
+ */
+
+#ifndef HOST_SCHEDULER_MT_H_
+#define HOST_SCHEDULER_MT_H_
+
+#include <pthread.h>
+#include <semaphore.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include "scheduler.h"
+
+#define SCH_MT_MAX_WORKERS  64
+#define SCH_MT_QUEUE_LEN    256     // Per worker, power of two
+
+struct SCH_MT;
+struct SCH_MT_Job;
+
+typedef struct SCH_MT_Command {
+    struct SCH_MT_Job* Job;
+    struct SCH_MT_Command* Next;
+} SCH_MT_Command;
+
+typedef struct SCH_MT_Job {
+    struct SCH_MT* Owner;
+    void (*Func)(void*);
+    void* Arg;
+    uint32_t Delay;
+    uint32_t Period;
+    uint32_t Home;                  // Preferred worker
+    uint32_t TaskID;                // In the timer thread's context
+    uint8_t Scheduled;              // Timer thread only
+    struct SCH_MT_Job* PrevScheduled;   // Scheduled jobs list, timer thread only
+    struct SCH_MT_Job* NextScheduled;
+    atomic_uint Refs;               // Schedule + caller handle + queued/running
+    atomic_uint Busy;               // Queued or running
+    atomic_ullong Runs;
+    atomic_ullong Skipped;          // Releases dropped because still busy
+    SCH_MT_Command Add;             // Each pushed at most once
+    SCH_MT_Command Delete;
+} SCH_MT_Job;
+
+typedef struct {
+    pthread_mutex_t Lock;           // Held for O(1) only
+    SCH_MT_Job* Ring[SCH_MT_QUEUE_LEN];
+    uint32_t Head;                  // Next job to run
+    uint32_t Tail;                  // Next free entry
+    uint64_t Executed;
+    uint64_t Stolen;
+    char Pad[64];
+} SCH_MT_Queue;
+
+typedef struct {
+    struct SCH_MT* Mt;
+    uint32_t Index;
+} SCH_MT_Worker_Arg;
+
+typedef struct SCH_MT {
+    SCH_Context Sched;              // Timer thread only
+    SCH_MT_Job* Scheduled;          // Jobs with a task in Sched, timer thread only
+    uint32_t TickMs;
+    uint32_t Workers;
+    SCH_MT_Queue Queues[SCH_MT_MAX_WORKERS];
+    sem_t Ready;                    // One post per queued job
+    _Atomic(SCH_MT_Command*) Commands;  // Lock-free command stack
+    atomic_uint NextHome;
+    atomic_int Stop;
+    pthread_t Timer;
+    pthread_t Threads[SCH_MT_MAX_WORKERS];
+    SCH_MT_Worker_Arg WorkerArgs[SCH_MT_MAX_WORKERS];
+    uint64_t MaxTimerLag_ns;        // Worst lateness of a tick update
+    uint64_t Dropped;               // Releases lost to full queues
+} SCH_MT;
+
+int SCH_MT_Init(SCH_MT* mt, uint32_t workers, uint32_t tickMs);
+int SCH_MT_Start(SCH_MT* mt);
+void SCH_MT_Stop(SCH_MT* mt);
+
+SCH_MT_Job* SCH_MT_Add_Task(SCH_MT* mt, void (*pFunction)(void*), void* arg, uint32_t DELAY, uint32_t PERIOD);
+void SCH_MT_Delete_Task(SCH_MT* mt, SCH_MT_Job* job);
+void SCH_MT_Release_Job(SCH_MT_Job* job);
+
+#endif /* HOST_SCHEDULER_MT_H_ */
@@ -0,0 +1,44 @@
+/*
+ * sim.h
+ *
+ * Host simulation of the scheduler with the real scheduler.c and the
+ * application tasks. Each SIM_Sim owns a scheduler context, a virtual
+ * clock and the simulated GPIO output registers.
+ */
+
+#ifndef HOST_SIM_H_
+#define HOST_SIM_H_
+
+#include <stdint.h>
+#include "stm32f1xx_hal.h"
+#include "scheduler.h"
+
+typedef struct SIM_Sim SIM_Sim;
+
+/* Called after every change of an output register */
+typedef void (*SIM_GPIO_Hook)(SIM_Sim* sim, uint8_t port, uint16_t changed, uint16_t odr);
+
+/* Called after every dispatch that had due tasks */
+typedef void (*SIM_Dispatch_Hook)(SIM_Sim* sim);
+
+struct SIM_Sim {
+    SCH_Context Sched;              // Scheduler under simulation
+    uint16_t ODR[SIM_GPIO_PORTS];   // Simulated output data registers
+    SIM_GPIO_Hook OnGPIO;           // Optional observer of pin changes
+    SIM_Dispatch_Hook OnDispatch;   // Optional observer of wakeups
+    void* User;                     // Free for the observer
+    uint64_t Wakeups;               // Ticks on which dispatch had work
+    uint64_t PinOps;                // GPIO calls made by tasks
+    uint8_t Started;                // Tick 0 already dispatched
+};
+
+/* Run mode for SIM_Run() */
+#define SIM_TICK_BY_TICK    0       // Update + dispatch on every tick
+#define SIM_FAST_FORWARD    1       // Jump the clock to the next deadline
+
+void SIM_Init(SIM_Sim* sim);
+void SIM_Run(SIM_Sim* sim, uint32_t ticks, uint8_t mode);
+SIM_Sim* SIM_Current(void);
+void SIM_Set_Current(SIM_Sim* sim);
+
+#endif /* HOST_SIM_H_ */
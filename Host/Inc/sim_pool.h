@@ -0,0 +1,23 @@
+/*
+ * sim_pool.h
+ *
+ * Work-stealing thread pool for running many independent simulations.
+ *
+ * Jobs are numbered 0..count-1. Each worker starts with a contiguous slice
+ * and takes jobs from its front; an idle worker steals the back half of the
+ * largest remaining slice. Slices are single 64-bit atomics, so there are
+ * no locks and no shared queue to contend on.
+ */
+
+#ifndef HOST_SIM_POOL_H_
+#define HOST_SIM_POOL_H_
+
+#include <stdint.h>
+
+/* Called once per job; 'worker' is in [0, threads) */
+typedef void (*SIM_Job)(uint32_t job, uint32_t worker, void* user);
+
+uint32_t SIM_Pool_Default_Threads(void);
+void SIM_Pool_Run(uint32_t count, uint32_t threads, SIM_Job job, void* user);
+
+#endif /* HOST_SIM_POOL_H_ */
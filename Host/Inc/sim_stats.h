@@ -0,0 +1,27 @@
+/*
+ * sim_stats.h
+ *
+ * Log-linear histogram for latency statistics. Values below 16 are exact,
+ * larger values land in one of 8 sub-buckets per power of two (at most
+ * 12.5% error). Histograms of different threads are merged by addition.
+ */
+
+#ifndef HOST_SIM_STATS_H_
+#define HOST_SIM_STATS_H_
+
+#include <stdint.h>
+
+#define SIM_HIST_BUCKETS    (16 + 28 * 8)
+
+typedef struct {
+    uint64_t Count[SIM_HIST_BUCKETS];
+    uint64_t Total;
+    uint64_t Sum;
+    uint32_t Max;
+} SIM_Hist;
+
+void SIM_Hist_Add(SIM_Hist* h, uint32_t value);
+void SIM_Hist_Merge(SIM_Hist* dst, const SIM_Hist* src);
+uint32_t SIM_Hist_Percentile(const SIM_Hist* h, double pct);
+
+#endif /* HOST_SIM_STATS_H_ */
@@ -0,0 +1,67 @@
+/*
+ * sim_timeline.h
+ *
+ * GPIO timeline of a simulation run, stored in a compact binary form and
+ * compared against a golden copy to catch timing regressions.
+ *
+ * File layout (little endian):
+ *   "SCHTL1\0\0"  u32 ticks  u32 events
+ *   then per event: varint tick delta, u8 kind<<4 | port, and
+ *     SIM_TL_EDGE: varint changed pins, varint new level of those pins
+ *     SIM_TL_WORK: varint GPIO calls made by the tasks of that dispatch
+ */
+
+#ifndef HOST_SIM_TIMELINE_H_
+#define HOST_SIM_TIMELINE_H_
+
+#include <stdint.h>
+#include <stdio.h>
+#include "sim.h"
+
+#define SIM_TL_EDGE     0           // Output pins changed
+#define SIM_TL_WORK     1           // Dispatch with due tasks
+
+typedef struct {
+    uint32_t Tick;
+    uint8_t Kind;
+    uint8_t Port;
+    uint16_t Changed;               // EDGE: pins that changed
+    uint32_t Value;                 // EDGE: level of those pins, WORK: GPIO calls
+} SIM_TL_Event;
+
+typedef struct {
+    SIM_TL_Event* Events;
+    uint32_t Count;
+    uint32_t Capacity;
+    uint32_t Ticks;                 // Length of the recorded run
+    uint64_t LastPinOps;            // Recorder state
+} SIM_Timeline;
+
+/* Limits for SIM_TL_Diff() */
+typedef struct {
+    uint32_t DriftWindow;           // Max shift (ticks) still paired as drift
+    uint32_t MaxReports;            // Detail lines printed per category
+} SIM_TL_Options;
+
+typedef struct {
+    uint32_t Drifted;               // Edges present in both but moved
+    int32_t MaxDrift;               // Largest shift, signed (new - golden)
+    uint32_t Missing;               // Golden edges with no counterpart
+    uint32_t Extra;                 // New edges with no counterpart
+    uint32_t WorkChanged;           // Ticks whose amount of work differs
+} SIM_TL_Result;
+
+void SIM_TL_Init(SIM_Timeline* tl);
+void SIM_TL_Free(SIM_Timeline* tl);
+
+/* Run 'sim' for 'ticks' ticks and record everything into 'tl' */
+void SIM_TL_Record(SIM_Timeline* tl, SIM_Sim* sim, uint32_t ticks, uint8_t mode);
+
+int SIM_TL_Save(const SIM_Timeline* tl, const char* path);
+int SIM_TL_Load(SIM_Timeline* tl, const char* path);
+
+/* Compare 'now' against 'golden'; details go to 'out' (may be NULL) */
+void SIM_TL_Diff(const SIM_Timeline* golden, const SIM_Timeline* now,
+                 const SIM_TL_Options* opt, SIM_TL_Result* res, FILE* out);
+
+#endif /* HOST_SIM_TIMELINE_H_ */
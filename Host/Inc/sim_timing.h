@@ -0,0 +1,77 @@
+/*
+ * sim_timing.h
+ *
+ * Execution-time model of one device for offline timing analysis.
+ *
+ * The real scheduler.c runs against a virtual CPU clock in microseconds.
+ * Each task consumes a sampled execution time; timer ticks that fall
+ * inside a running task call SCH_Ctx_Update() at the exact point they
+ * would interrupt it on target, so backlog and drift behave as on the
+ * device. Idle stretches are skipped with SCH_Ctx_Advance().
+ *
+ * Response time is measured from the tick at which a job became due to its
+ * completion; a job finishing more than one period after its release is a
+ * deadline miss. The delta list does not age while a due task waits, so
+ * every tick that passes with a task pending shifts all later releases by
+ * one tick. Those ticks are counted as LostTicks (drift from the nominal
+ * Offset + k * Period timeline).
+ */
+
+#ifndef HOST_SIM_TIMING_H_
+#define HOST_SIM_TIMING_H_
+
+#include <stdint.h>
+#include "scheduler.h"
+#include "sim_stats.h"
+
+#define SIM_TICK_US         10000   // 10ms scheduler tick
+
+/* Execution time distributions, parameters in microseconds */
+#define SIM_EXEC_FIXED      0       // A
+#define SIM_EXEC_UNIFORM    1       // A .. B
+#define SIM_EXEC_NORMAL     2       // mean A, deviation B, clamped at 0
+#define SIM_EXEC_BIMODAL    3       // A, but B with 1% probability
+
+typedef struct {
+    uint32_t Period;                // Ticks
+    uint32_t Offset;                // Ticks before first release
+    uint8_t ExecKind;               // SIM_EXEC_*
+    uint32_t ExecA;
+    uint32_t ExecB;
+} SIM_TaskSpec;
+
+typedef struct SIM_Device SIM_Device;
+
+typedef struct {
+    SIM_TaskSpec Spec;
+    SIM_Device* Device;
+    uint64_t Jobs;                  // Completed jobs
+    uint64_t Misses;                // Jobs finished after their deadline
+    uint32_t MaxResponse;           // Worst response time, us
+    SIM_Hist* Response;             // Optional per-task histogram
+} SIM_TimingTask;
+
+struct SIM_Device {
+    SCH_Context Sched;
+    SIM_TimingTask* Tasks;
+    uint32_t NumTasks;
+    uint64_t Rng;                   // Execution time sampling state
+    uint64_t Now;                   // CPU clock, us
+    uint64_t NextTick;              // Time of next timer interrupt, us
+    uint64_t Busy;                  // Total execution time, us
+    uint32_t TickBusy;              // Execution time in current tick, us
+    uint32_t PeakTickBusy;          // Worst execution time within a tick, us
+    uint64_t ReleaseTime;           // Tick at which the pending jobs became due, us
+    uint32_t LostTicks;             // Ticks that passed with a job pending
+    SIM_Hist* Response;             // Optional device-wide histogram
+};
+
+void SIM_Device_Init(SIM_Device* dev, const SIM_TaskSpec* specs, SIM_TimingTask* tasks,
+                     uint32_t numTasks, uint64_t seed);
+void SIM_Device_Run(SIM_Device* dev, uint32_t ticks);
+void SIM_Device_Free(SIM_Device* dev);
+
+uint64_t SIM_Rand(uint64_t* state);
+double SIM_Rand_Unit(uint64_t* state);
+
+#endif /* HOST_SIM_TIMING_H_ */
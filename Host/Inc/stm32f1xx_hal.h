@@ -0,0 +1,59 @@
+/*
+ * stm32f1xx_hal.h (host)
+ *
+ * Minimal stand-in for the STM32 HAL used when building application code
+ * (Core/Src/Tasks.c etc.) for the host simulation. Put Host/Inc ahead of
+ * the Drivers include paths so Core/Inc/main.h picks this file up.
+ *
+ * Only the GPIO subset used by the tasks is provided. Pin writes are routed
+ * to the simulation instance running on the calling thread (see sim.h).
+ */
+
+#ifndef HOST_STM32F1XX_HAL_H_
+#define HOST_STM32F1XX_HAL_H_
+
+#include <stdint.h>
+
+#define GPIO_PIN_0      ((uint16_t)0x0001)
+#define GPIO_PIN_1      ((uint16_t)0x0002)
+#define GPIO_PIN_2      ((uint16_t)0x0004)
+#define GPIO_PIN_3      ((uint16_t)0x0008)
+#define GPIO_PIN_4      ((uint16_t)0x0010)
+#define GPIO_PIN_5      ((uint16_t)0x0020)
+#define GPIO_PIN_6      ((uint16_t)0x0040)
+#define GPIO_PIN_7      ((uint16_t)0x0080)
+#define GPIO_PIN_8      ((uint16_t)0x0100)
+#define GPIO_PIN_9      ((uint16_t)0x0200)
+#define GPIO_PIN_10     ((uint16_t)0x0400)
+#define GPIO_PIN_11     ((uint16_t)0x0800)
+#define GPIO_PIN_12     ((uint16_t)0x1000)
+#define GPIO_PIN_13     ((uint16_t)0x2000)
+#define GPIO_PIN_14     ((uint16_t)0x4000)
+#define GPIO_PIN_15     ((uint16_t)0x8000)
+#define GPIO_PIN_All    ((uint16_t)0xFFFF)
+
+/* A port only identifies which simulated ODR register a call refers to */
+typedef struct {
+    uint8_t Index;
+} GPIO_TypeDef;
+
+#define SIM_GPIO_PORTS  3
+
+extern GPIO_TypeDef SIM_GPIOA;
+extern GPIO_TypeDef SIM_GPIOB;
+extern GPIO_TypeDef SIM_GPIOC;
+
+#define GPIOA (&SIM_GPIOA)
+#define GPIOB (&SIM_GPIOB)
+#define GPIOC (&SIM_GPIOC)
+
+typedef enum {
+    GPIO_PIN_RESET = 0,
+    GPIO_PIN_SET
+} GPIO_PinState;
+
+GPIO_PinState HAL_GPIO_ReadPin(GPIO_TypeDef* GPIOx, uint16_t GPIO_Pin);
+void HAL_GPIO_WritePin(GPIO_TypeDef* GPIOx, uint16_t GPIO_Pin, GPIO_PinState PinState);
+void HAL_GPIO_TogglePin(GPIO_TypeDef* GPIOx, uint16_t GPIO_Pin);
+
+#endif /* HOST_STM32F1XX_HAL_H_ */
@@ -0,0 +1,280 @@
+/*
+ * port_linux.c
+ */
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/epoll.h>
+#include <sys/timerfd.h>
+#include <time.h>
+#include <unistd.h>
+#include "port_linux.h"
+
+static uint64_t PORT_Now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static struct timespec PORT_Timespec(uint64_t ns) {
+    struct timespec ts;
+    ts.tv_sec = (time_t)(ns / 1000000000ull);
+    ts.tv_nsec = (long)(ns % 1000000000ull);
+    return ts;
+}
+
+/*----------------------------------------------------------------------------
+ * GPIO output backends
+ *---------------------------------------------------------------------------*/
+
+/* Print "time_ms port pin level" for every changed pin */
+void PORT_GPIO_Log(SIM_Sim* sim, uint8_t port, uint16_t changed, uint16_t odr) {
+    uint32_t ms = SCH_Ctx_Get_Current_Time(&sim->Sched);
+
+    for (uint8_t pin = 0; pin < 16; pin++) {
+        if (changed & (1u << pin)) {
+            printf("%10u P%c%u %u\n", (unsigned)ms, 'A' + port, pin, (odr >> pin) & 1u);
+        }
+    }
+    fflush(stdout);
+}
+
+static int g_SysfsFd[SIM_GPIO_PORTS][16];
+static uint8_t g_SysfsMapped = 0;
+
+/*
+ * Route a simulated pin to /sys/class/gpio/gpioN/value. The GPIO must
+ * already be exported and configured as an output.
+ */
+int PORT_GPIO_Sysfs_Map(uint8_t port, uint8_t pin, int linuxGpio) {
+    char path[64];
+
+    if (!g_SysfsMapped) {
+        memset(g_SysfsFd, 0xFF, sizeof(g_SysfsFd));
+        g_SysfsMapped = 1;
+    }
+    if (port >= SIM_GPIO_PORTS || pin >= 16) {
+        return -1;
+    }
+    snprintf(path, sizeof(path), "/sys/class/gpio/gpio%d/value", linuxGpio);
+    g_SysfsFd[port][pin] = open(path, O_WRONLY | O_CLOEXEC);
+    return g_SysfsFd[port][pin] < 0 ? -1 : 0;
+}
+
+void PORT_GPIO_Sysfs(SIM_Sim* sim, uint8_t port, uint16_t changed, uint16_t odr) {
+    (void)sim;
+
+    if (!g_SysfsMapped) {
+        return;
+    }
+    for (uint8_t pin = 0; pin < 16; pin++) {
+        int fd = g_SysfsFd[port][pin];
+
+        if ((changed & (1u << pin)) && fd >= 0) {
+            char level = ((odr >> pin) & 1u) ? '1' : '0';
+            if (pwrite(fd, &level, 1, 0) != 1) {
+                perror("gpio");
+            }
+        }
+    }
+}
+
+/*----------------------------------------------------------------------------
+ * Event loop
+ *---------------------------------------------------------------------------*/
+
+int PORT_Linux_Init(PORT_Linux* port, uint32_t tickMs, uint8_t tickless) {
+    struct epoll_event ev;
+
+    memset(port, 0, sizeof(*port));
+    SIM_Init(&port->Device);
+    port->Device.OnGPIO = PORT_GPIO_Log;
+    port->TickMs = tickMs;
+    port->Tickless = tickless;
+    for (uint32_t i = 0; i < PORT_MAX_WATCHES; i++) {
+        port->Watches[i].Fd = -1;
+    }
+
+    port->EpollFd = epoll_create1(EPOLL_CLOEXEC);
+    port->TimerFd = timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC | TFD_NONBLOCK);
+    if (port->EpollFd < 0 || port->TimerFd < 0) {
+        return -1;
+    }
+
+    ev.events = EPOLLIN;
+    ev.data.ptr = NULL;         // NULL marks the tick timer
+    return epoll_ctl(port->EpollFd, EPOLL_CTL_ADD, port->TimerFd, &ev);
+}
+
+SCH_Context* PORT_Linux_Context(PORT_Linux* port) {
+    return &port->Device.Sched;
+}
+
+/* Scheduler task queued when a watched descriptor becomes ready */
+static void PORT_Fd_Task(void* arg) {
+    PORT_Watch* w = (PORT_Watch*)arg;
+    struct epoll_event ev;
+
+    w->Queued = 0;
+    if (w->Fd < 0) {
+        return;                 // Unwatched while queued
+    }
+    w->Handler(w->Fd, w->Ready, w->Arg);
+
+    // The handler may have unwatched it; otherwise listen again
+    if (w->Fd >= 0) {
+        ev.events = w->Events | EPOLLONESHOT;
+        ev.data.ptr = w;
+        epoll_ctl(w->Port->EpollFd, EPOLL_CTL_MOD, w->Fd, &ev);
+    }
+}
+
+int PORT_Linux_Watch_Fd(PORT_Linux* port, int fd, uint32_t events, PORT_Fd_Handler handler, void* arg) {
+    struct epoll_event ev;
+
+    for (uint32_t i = 0; i < PORT_MAX_WATCHES; i++) {
+        PORT_Watch* w = &port->Watches[i];
+
+        if (w->Fd < 0 && !w->Queued) {
+            w->Port = port;
+            w->Fd = fd;
+            w->Events = events;
+            w->Handler = handler;
+            w->Arg = arg;
+            ev.events = events | EPOLLONESHOT;
+            ev.data.ptr = w;
+            if (epoll_ctl(port->EpollFd, EPOLL_CTL_ADD, fd, &ev) != 0) {
+                w->Fd = -1;
+                return -1;
+            }
+            return 0;
+        }
+    }
+    errno = ENOSPC;
+    return -1;
+}
+
+int PORT_Linux_Unwatch_Fd(PORT_Linux* port, int fd) {
+    for (uint32_t i = 0; i < PORT_MAX_WATCHES; i++) {
+        PORT_Watch* w = &port->Watches[i];
+
+        if (w->Fd == fd) {
+            w->Fd = -1;
+            return epoll_ctl(port->EpollFd, EPOLL_CTL_DEL, fd, NULL);
+        }
+    }
+    errno = ENOENT;
+    return -1;
+}
+
+/* Arm the timer: every tick, or (tickless) only for the next deadline */
+static void PORT_Arm_Timer(PORT_Linux* port) {
+    uint64_t tick_ns = (uint64_t)port->TickMs * 1000000ull;
+    struct itimerspec its;
+
+    memset(&its, 0, sizeof(its));
+    if (!port->Tickless) {
+        its.it_value = PORT_Timespec(port->Start_ns + tick_ns);
+        its.it_interval = PORT_Timespec(tick_ns);
+    } else {
+        uint32_t next = SCH_Ctx_Get_Ticks_To_Next(&port->Device.Sched);
+
+        if (next == SCH_NO_DEADLINE) {
+            // Nothing timed left: disarm and wait for descriptors only
+        } else {
+            uint64_t tick = (uint64_t)SCH_Ctx_Get_Current_Tick(&port->Device.Sched) + (next ? next : 1);
+            its.it_value = PORT_Timespec(port->Start_ns + tick * tick_ns);
+        }
+    }
+    timerfd_settime(port->TimerFd, TFD_TIMER_ABSTIME, &its, NULL);
+}
+
+/* Periodic mode: one update per expiration, like back-to-back interrupts */
+static void PORT_Apply_Ticks(PORT_Linux* port) {
+    uint64_t expirations;
+
+    if (read(port->TimerFd, &expirations, sizeof(expirations)) != sizeof(expirations)) {
+        return;
+    }
+    if (!port->Tickless) {
+        port->Overruns += expirations - 1;
+        while (expirations-- > 0) {
+            SCH_Ctx_Update(&port->Device.Sched);
+        }
+    }
+}
+
+/* Tickless mode: bring the tick count up to the wall clock on every wakeup */
+static void PORT_Catch_Up(PORT_Linux* port) {
+    SCH_Context* ctx = &port->Device.Sched;
+    uint64_t tick_ns = (uint64_t)port->TickMs * 1000000ull;
+    uint64_t target = (PORT_Now_ns() - port->Start_ns) / tick_ns;
+    uint32_t elapsed = (uint32_t)(target - SCH_Ctx_Get_Current_Tick(ctx));
+    uint32_t next = SCH_Ctx_Get_Ticks_To_Next(ctx);
+
+    // A late wakeup still dispatches the due task, just later
+    if (next != SCH_NO_DEADLINE && elapsed > next) {
+        port->Overruns += elapsed - next;
+    }
+    SCH_Ctx_Advance(ctx, elapsed);
+}
+
+/*
+ * Run the loop until PORT_Linux_Stop() is called (from a task, a handler
+ * or a signal handler). Returns 0, or -1 on an epoll error.
+ */
+int PORT_Linux_Run(PORT_Linux* port) {
+    struct epoll_event events[PORT_MAX_WATCHES + 1];
+
+    SIM_Set_Current(&port->Device);
+    port->Start_ns = PORT_Now_ns();
+    PORT_Arm_Timer(port);
+
+    while (!port->Stop) {
+        int n;
+
+        SCH_Ctx_Dispatch_Tasks(&port->Device.Sched);
+        if (port->Tickless) {
+            PORT_Arm_Timer(port);
+        }
+        if (port->Stop) {
+            break;
+        }
+
+        n = epoll_wait(port->EpollFd, events, PORT_MAX_WATCHES + 1, -1);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return -1;
+        }
+
+        if (port->Tickless) {
+            PORT_Catch_Up(port);
+        }
+        for (int i = 0; i < n; i++) {
+            PORT_Watch* w = (PORT_Watch*)events[i].data.ptr;
+
+            if (w == NULL) {
+                PORT_Apply_Ticks(port);
+            } else if (w->Fd >= 0 && !w->Queued) {
+                w->Ready = events[i].events;
+                w->Queued = 1;
+                SCH_Ctx_Add_Task_Arg(&port->Device.Sched, PORT_Fd_Task, w, 0, 0);
+            }
+        }
+    }
+    return 0;
+}
+
+void PORT_Linux_Stop(PORT_Linux* port) {
+    port->Stop = 1;
+}
+
+void PORT_Linux_Close(PORT_Linux* port) {
+    close(port->TimerFd);
+    close(port->EpollFd);
+    SCH_Ctx_Deinit(&port->Device.Sched);
+    SIM_Set_Current(NULL);
+}
@@ -0,0 +1,300 @@
+/*
+ * scheduler_mt.c
+ */
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "scheduler_mt.h"
+
+static uint64_t SCH_MT_Now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+/* Drop one reference; the last one frees the job */
+void SCH_MT_Release_Job(SCH_MT_Job* job) {
+    if (atomic_fetch_sub(&job->Refs, 1) == 1) {
+        free(job);
+    }
+}
+
+/*----------------------------------------------------------------------------
+ * Worker queues
+ *---------------------------------------------------------------------------*/
+static int SCH_MT_Push(SCH_MT_Queue* q, SCH_MT_Job* job) {
+    int ok = 0;
+
+    pthread_mutex_lock(&q->Lock);
+    if (q->Tail - q->Head < SCH_MT_QUEUE_LEN) {
+        q->Ring[q->Tail++ & (SCH_MT_QUEUE_LEN - 1)] = job;
+        ok = 1;
+    }
+    pthread_mutex_unlock(&q->Lock);
+    return ok;
+}
+
+static SCH_MT_Job* SCH_MT_Pop(SCH_MT_Queue* q) {
+    SCH_MT_Job* job = NULL;
+
+    pthread_mutex_lock(&q->Lock);
+    if (q->Head != q->Tail) {
+        job = q->Ring[q->Head++ & (SCH_MT_QUEUE_LEN - 1)];
+    }
+    pthread_mutex_unlock(&q->Lock);
+    return job;
+}
+
+static void* SCH_MT_Worker(void* arg) {
+    SCH_MT* mt = ((SCH_MT_Worker_Arg*)arg)->Mt;
+    uint32_t self = ((SCH_MT_Worker_Arg*)arg)->Index;
+    SCH_MT_Queue* own = &mt->Queues[self];
+
+    for (;;) {
+        SCH_MT_Job* job;
+
+        while (sem_wait(&mt->Ready) != 0 && errno == EINTR) {
+        }
+        if (atomic_load(&mt->Stop)) {
+            break;
+        }
+
+        // The post guarantees a job somewhere: own queue first, then steal
+        job = SCH_MT_Pop(own);
+        for (uint32_t i = 1; job == NULL; i++) {
+            job = SCH_MT_Pop(&mt->Queues[(self + i) % mt->Workers]);
+            if (job != NULL) {
+                own->Stolen++;
+            }
+        }
+
+        job->Func(job->Arg);
+        atomic_fetch_add(&job->Runs, 1);
+        own->Executed++;
+        atomic_store(&job->Busy, 0);
+        SCH_MT_Release_Job(job);
+    }
+    return NULL;
+}
+
+/*----------------------------------------------------------------------------
+ * Timer thread
+ *---------------------------------------------------------------------------*/
+
+static void SCH_MT_Schedule(SCH_MT* mt, SCH_MT_Job* job) {
+    job->Scheduled = 1;
+    job->PrevScheduled = NULL;
+    job->NextScheduled = mt->Scheduled;
+    if (mt->Scheduled != NULL) {
+        mt->Scheduled->PrevScheduled = job;
+    }
+    mt->Scheduled = job;
+}
+
+static void SCH_MT_Unschedule(SCH_MT* mt, SCH_MT_Job* job) {
+    if (job->PrevScheduled != NULL) {
+        job->PrevScheduled->NextScheduled = job->NextScheduled;
+    } else {
+        mt->Scheduled = job->NextScheduled;
+    }
+    if (job->NextScheduled != NULL) {
+        job->NextScheduled->PrevScheduled = job->PrevScheduled;
+    }
+    job->Scheduled = 0;
+    SCH_MT_Release_Job(job);
+}
+
+/* Task body seen by the scheduler: hand the job to a worker */
+static void SCH_MT_Dispatch_Job(void* arg) {
+    SCH_MT_Job* job = (SCH_MT_Job*)arg;
+    SCH_MT* mt = job->Owner;
+    uint32_t w;
+
+    if (atomic_exchange(&job->Busy, 1) != 0) {
+        atomic_fetch_add(&job->Skipped, 1);
+    } else {
+        atomic_fetch_add(&job->Refs, 1);
+        for (w = 0; w < mt->Workers; w++) {
+            if (SCH_MT_Push(&mt->Queues[(job->Home + w) % mt->Workers], job)) {
+                sem_post(&mt->Ready);
+                break;
+            }
+        }
+        if (w == mt->Workers) {
+            mt->Dropped++;
+            atomic_store(&job->Busy, 0);
+            SCH_MT_Release_Job(job);
+        }
+    }
+
+    // The scheduler frees one-shot tasks after this returns
+    if (job->Period == 0) {
+        SCH_MT_Unschedule(mt, job);
+    }
+}
+
+static void SCH_MT_Run_Commands(SCH_MT* mt) {
+    SCH_MT_Command* list = atomic_exchange(&mt->Commands, NULL);
+    SCH_MT_Command* fifo = NULL;
+
+    // The stack is newest first; reverse to apply in submission order
+    while (list != NULL) {
+        SCH_MT_Command* next = list->Next;
+        list->Next = fifo;
+        fifo = list;
+        list = next;
+    }
+
+    while (fifo != NULL) {
+        SCH_MT_Job* job = fifo->Job;
+        uint8_t add = (fifo == &job->Add);
+
+        fifo = fifo->Next;
+
+        if (add) {
+            job->TaskID = SCH_Ctx_Add_Task_Arg(&mt->Sched, SCH_MT_Dispatch_Job, job, job->Delay, job->Period);
+            if (job->TaskID != NO_TASK_ID) {
+                SCH_MT_Schedule(mt, job);
+            } else {
+                SCH_MT_Release_Job(job);
+            }
+        } else if (job->Scheduled) {
+            SCH_Ctx_Delete_Task(&mt->Sched, job->TaskID);
+            SCH_MT_Unschedule(mt, job);
+        }
+        SCH_MT_Release_Job(job);    // Reference held by the command
+    }
+}
+
+static void SCH_MT_Push_Command(SCH_MT* mt, SCH_MT_Command* cmd) {
+    SCH_MT_Command* top = atomic_load(&mt->Commands);
+
+    atomic_fetch_add(&cmd->Job->Refs, 1);
+    do {
+        cmd->Next = top;
+    } while (!atomic_compare_exchange_weak(&mt->Commands, &top, cmd));
+}
+
+static void* SCH_MT_Timer(void* arg) {
+    SCH_MT* mt = (SCH_MT*)arg;
+    uint64_t tick_ns = (uint64_t)mt->TickMs * 1000000ull;
+    uint64_t next = SCH_MT_Now_ns() + tick_ns;
+
+    while (!atomic_load(&mt->Stop)) {
+        struct timespec ts;
+        uint64_t now, lag;
+
+        ts.tv_sec = (time_t)(next / 1000000000ull);
+        ts.tv_nsec = (long)(next % 1000000000ull);
+        while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) == EINTR) {
+        }
+
+        now = SCH_MT_Now_ns();
+        lag = now - next;
+        if (lag > mt->MaxTimerLag_ns) {
+            mt->MaxTimerLag_ns = lag;
+        }
+
+        SCH_MT_Run_Commands(mt);
+        while (next <= now) {
+            SCH_Ctx_Update(&mt->Sched);
+            next += tick_ns;
+        }
+        SCH_Ctx_Dispatch_Tasks(&mt->Sched);
+    }
+    return NULL;
+}
+
+/*----------------------------------------------------------------------------
+ * Public API
+ *---------------------------------------------------------------------------*/
+int SCH_MT_Init(SCH_MT* mt, uint32_t workers, uint32_t tickMs) {
+    memset(mt, 0, sizeof(*mt));
+    if (workers == 0 || workers > SCH_MT_MAX_WORKERS) {
+        return -1;
+    }
+    SCH_Ctx_Init(&mt->Sched);
+    mt->TickMs = tickMs;
+    mt->Workers = workers;
+    for (uint32_t i = 0; i < workers; i++) {
+        pthread_mutex_init(&mt->Queues[i].Lock, NULL);
+    }
+    atomic_init(&mt->Commands, NULL);
+    return sem_init(&mt->Ready, 0, 0);
+}
+
+int SCH_MT_Start(SCH_MT* mt) {
+    for (uint32_t i = 0; i < mt->Workers; i++) {
+        mt->WorkerArgs[i].Mt = mt;
+        mt->WorkerArgs[i].Index = i;
+        if (pthread_create(&mt->Threads[i], NULL, SCH_MT_Worker, &mt->WorkerArgs[i]) != 0) {
+            return -1;
+        }
+    }
+    return pthread_create(&mt->Timer, NULL, SCH_MT_Timer, mt);
+}
+
+/* Stop the timer, let workers finish their current job and join them */
+void SCH_MT_Stop(SCH_MT* mt) {
+    atomic_store(&mt->Stop, 1);
+    pthread_join(mt->Timer, NULL);
+    for (uint32_t i = 0; i < mt->Workers; i++) {
+        sem_post(&mt->Ready);
+    }
+    for (uint32_t i = 0; i < mt->Workers; i++) {
+        pthread_join(mt->Threads[i], NULL);
+    }
+    SCH_MT_Run_Commands(mt);
+
+    // Jobs that were queued but never run
+    for (uint32_t i = 0; i < mt->Workers; i++) {
+        SCH_MT_Job* job;
+        while ((job = SCH_MT_Pop(&mt->Queues[i])) != NULL) {
+            atomic_store(&job->Busy, 0);
+            SCH_MT_Release_Job(job);
+        }
+    }
+
+    // Jobs still scheduled lose the timer context's reference
+    while (mt->Scheduled != NULL) {
+        SCH_MT_Unschedule(mt, mt->Scheduled);
+    }
+    SCH_Ctx_Deinit(&mt->Sched);
+    sem_destroy(&mt->Ready);
+}
+
+/*
+ * Add a task from any thread. It is scheduled at the next tick; DELAY and
+ * PERIOD are in ticks as for SCH_Add_Task(). The returned handle stays
+ * valid until passed to SCH_MT_Delete_Task() or, after SCH_MT_Stop(), to
+ * SCH_MT_Release_Job().
+ */
+SCH_MT_Job* SCH_MT_Add_Task(SCH_MT* mt, void (*pFunction)(void*), void* arg, uint32_t DELAY, uint32_t PERIOD) {
+    SCH_MT_Job* job = calloc(1, sizeof(SCH_MT_Job));
+
+    if (job == NULL) {
+        return NULL;
+    }
+    job->Func = pFunction;
+    job->Arg = arg;
+    job->Delay = DELAY;
+    job->Period = PERIOD;
+    job->Owner = mt;
+    job->Home = atomic_fetch_add(&mt->NextHome, 1) % mt->Workers;
+    job->Add.Job = job;
+    job->Delete.Job = job;
+    atomic_init(&job->Refs, 2);     // Schedule + caller handle
+    SCH_MT_Push_Command(mt, &job->Add);
+    return job;
+}
+
+/*
+ * Delete from any thread, once per handle and before SCH_MT_Stop(); a run
+ * already handed to a worker completes. Handles still held after
+ * SCH_MT_Stop() are dropped with SCH_MT_Release_Job().
+ */
+void SCH_MT_Delete_Task(SCH_MT* mt, SCH_MT_Job* job) {
+    SCH_MT_Push_Command(mt, &job->Delete);
+    SCH_MT_Release_Job(job);        // Caller handle
+}
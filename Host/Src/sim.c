@@ -0,0 +1,76 @@
+/*
+ * sim.c
+ *
+ * Host simulation driver. Models the firmware main loop: SCH_Update() on
+ * every timer tick followed by SCH_Dispatch_Tasks(), with tick 0 dispatched
+ * before the first interrupt.
+ *
+ * Fast-forward mode skips the idle ticks in between deadlines with
+ * SCH_Ctx_Advance(). Because a dispatch with nothing due is a no-op, it
+ * produces the same dispatch order and GPIO timeline as tick-by-tick mode.
+ */
+#include <string.h>
+#include "sim.h"
+
+static _Thread_local SIM_Sim* t_CurrentSim = NULL;
+
+void SIM_Init(SIM_Sim* sim) {
+    memset(sim, 0, sizeof(*sim));
+    SCH_Ctx_Init(&sim->Sched);
+}
+
+SIM_Sim* SIM_Current(void) {
+    return t_CurrentSim;
+}
+
+/* Bind GPIO calls of this thread to 'sim' outside of SIM_Run() */
+void SIM_Set_Current(SIM_Sim* sim) {
+    t_CurrentSim = sim;
+}
+
+static void SIM_Dispatch(SIM_Sim* sim) {
+    if (SCH_Ctx_Get_Ticks_To_Next(&sim->Sched) == 0) {
+        sim->Wakeups++;
+        SCH_Ctx_Dispatch_Tasks(&sim->Sched);
+        if (sim->OnDispatch != NULL) {
+            sim->OnDispatch(sim);
+        }
+    }
+}
+
+/*
+ * Run the simulation for 'ticks' timer ticks on the calling thread.
+ * May be called repeatedly to continue a run.
+ */
+void SIM_Run(SIM_Sim* sim, uint32_t ticks, uint8_t mode) {
+    SIM_Sim* saved = t_CurrentSim;
+
+    t_CurrentSim = sim;
+
+    if (!sim->Started) {
+        sim->Started = 1;
+        SIM_Dispatch(sim);
+    }
+
+    if (mode == SIM_TICK_BY_TICK) {
+        while (ticks-- > 0) {
+            SCH_Ctx_Update(&sim->Sched);
+            SIM_Dispatch(sim);
+        }
+    } else {
+        while (ticks > 0) {
+            uint32_t step = SCH_Ctx_Get_Ticks_To_Next(&sim->Sched);
+
+            if (step == 0) {
+                step = 1;           // Only if a dispatch was skipped
+            } else if (step > ticks) {
+                step = ticks;
+            }
+            SCH_Ctx_Advance(&sim->Sched, step);
+            ticks -= step;
+            SIM_Dispatch(sim);
+        }
+    }
+
+    t_CurrentSim = saved;
+}
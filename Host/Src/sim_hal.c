@@ -0,0 +1,44 @@
+/*
+ * sim_hal.c
+ *
+ * GPIO part of the host HAL stand-in. Pin operations act on the output
+ * registers of the simulation currently running on this thread.
+ */
+#include <stddef.h>
+#include "sim.h"
+
+GPIO_TypeDef SIM_GPIOA = { 0 };
+GPIO_TypeDef SIM_GPIOB = { 1 };
+GPIO_TypeDef SIM_GPIOC = { 2 };
+
+static void SIM_GPIO_Set_ODR(GPIO_TypeDef* GPIOx, uint16_t odr) {
+    SIM_Sim* sim = SIM_Current();
+    uint16_t changed = sim->ODR[GPIOx->Index] ^ odr;
+
+    sim->ODR[GPIOx->Index] = odr;
+    if (changed != 0 && sim->OnGPIO != NULL) {
+        sim->OnGPIO(sim, GPIOx->Index, changed, odr);
+    }
+}
+
+GPIO_PinState HAL_GPIO_ReadPin(GPIO_TypeDef* GPIOx, uint16_t GPIO_Pin) {
+    SIM_Current()->PinOps++;
+    return (SIM_Current()->ODR[GPIOx->Index] & GPIO_Pin) ? GPIO_PIN_SET : GPIO_PIN_RESET;
+}
+
+void HAL_GPIO_WritePin(GPIO_TypeDef* GPIOx, uint16_t GPIO_Pin, GPIO_PinState PinState) {
+    uint16_t odr = SIM_Current()->ODR[GPIOx->Index];
+
+    SIM_Current()->PinOps++;
+    SIM_GPIO_Set_ODR(GPIOx, PinState == GPIO_PIN_SET ? (odr | GPIO_Pin) : (odr & ~GPIO_Pin));
+}
+
+void HAL_GPIO_TogglePin(GPIO_TypeDef* GPIOx, uint16_t GPIO_Pin) {
+    SIM_Current()->PinOps++;
+    SIM_GPIO_Set_ODR(GPIOx, SIM_Current()->ODR[GPIOx->Index] ^ GPIO_Pin);
+}
+
+void Error_Handler(void) {
+    for (;;) {
+    }
+}
@@ -0,0 +1,136 @@
+/*
+ * sim_pool.c
+ */
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include "sim_pool.h"
+
+/* Remaining jobs [begin, end) packed as begin | end << 32 */
+typedef struct {
+    _Atomic uint64_t Range;
+    char Pad[64 - sizeof(uint64_t)];    // One slice per cache line
+} SIM_Slice;
+
+typedef struct {
+    SIM_Slice* Slices;
+    uint32_t Threads;
+    SIM_Job Job;
+    void* User;
+} SIM_Pool;
+
+typedef struct {
+    SIM_Pool* Pool;
+    uint32_t Worker;
+} SIM_Worker;
+
+#define SLICE(b, e)     ((uint64_t)(b) | ((uint64_t)(e) << 32))
+#define SLICE_BEGIN(r)  ((uint32_t)(r))
+#define SLICE_END(r)    ((uint32_t)((r) >> 32))
+
+uint32_t SIM_Pool_Default_Threads(void) {
+    long n = sysconf(_SC_NPROCESSORS_ONLN);
+    return n > 0 ? (uint32_t)n : 1;
+}
+
+/* Take the next job from the front of our own slice */
+static int SIM_Pool_Pop(SIM_Slice* s, uint32_t* job) {
+    uint64_t r = atomic_load_explicit(&s->Range, memory_order_relaxed);
+
+    while (SLICE_BEGIN(r) < SLICE_END(r)) {
+        if (atomic_compare_exchange_weak(&s->Range, &r, SLICE(SLICE_BEGIN(r) + 1, SLICE_END(r)))) {
+            *job = SLICE_BEGIN(r);
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/* Move the back half of the fullest victim slice into our own */
+static int SIM_Pool_Steal(SIM_Pool* pool, uint32_t self) {
+    for (;;) {
+        uint32_t victim = self, most = 0;
+
+        for (uint32_t i = 0; i < pool->Threads; i++) {
+            uint64_t r = atomic_load_explicit(&pool->Slices[i].Range, memory_order_relaxed);
+            uint32_t left = SLICE_END(r) - SLICE_BEGIN(r);
+
+            if (i != self && SLICE_BEGIN(r) < SLICE_END(r) && left > most) {
+                most = left;
+                victim = i;
+            }
+        }
+        if (victim == self) {
+            return 0;
+        }
+
+        uint64_t r = atomic_load(&pool->Slices[victim].Range);
+        uint32_t b = SLICE_BEGIN(r), e = SLICE_END(r);
+
+        if (b >= e) {
+            continue;
+        }
+        uint32_t mid = e - (e - b + 1) / 2;
+        if (atomic_compare_exchange_strong(&pool->Slices[victim].Range, &r, SLICE(b, mid))) {
+            // Our slice is empty, so nobody else writes it concurrently
+            atomic_store(&pool->Slices[self].Range, SLICE(mid, e));
+            return 1;
+        }
+    }
+}
+
+static void* SIM_Pool_Worker(void* arg) {
+    SIM_Worker* w = (SIM_Worker*)arg;
+    SIM_Pool* pool = w->Pool;
+    uint32_t job;
+
+    do {
+        while (SIM_Pool_Pop(&pool->Slices[w->Worker], &job)) {
+            pool->Job(job, w->Worker, pool->User);
+        }
+    } while (SIM_Pool_Steal(pool, w->Worker));
+
+    return NULL;
+}
+
+/*
+ * Run 'count' jobs on 'threads' workers (0 = one per online CPU) and wait
+ * for all of them. The calling thread acts as worker 0.
+ */
+void SIM_Pool_Run(uint32_t count, uint32_t threads, SIM_Job job, void* user) {
+    SIM_Pool pool;
+    SIM_Worker* workers;
+    pthread_t* tids;
+
+    if (threads == 0) {
+        threads = SIM_Pool_Default_Threads();
+    }
+
+    pool.Slices = aligned_alloc(64, sizeof(SIM_Slice) * threads);
+    pool.Threads = threads;
+    pool.Job = job;
+    pool.User = user;
+    workers = malloc(sizeof(SIM_Worker) * threads);
+    tids = malloc(sizeof(pthread_t) * threads);
+
+    for (uint32_t i = 0; i < threads; i++) {
+        uint32_t b = (uint32_t)((uint64_t)count * i / threads);
+        uint32_t e = (uint32_t)((uint64_t)count * (i + 1) / threads);
+
+        atomic_init(&pool.Slices[i].Range, SLICE(b, e));
+        workers[i].Pool = &pool;
+        workers[i].Worker = i;
+    }
+    for (uint32_t i = 1; i < threads; i++) {
+        pthread_create(&tids[i], NULL, SIM_Pool_Worker, &workers[i]);
+    }
+    SIM_Pool_Worker(&workers[0]);
+    for (uint32_t i = 1; i < threads; i++) {
+        pthread_join(tids[i], NULL);
+    }
+
+    free(tids);
+    free(workers);
+    free(pool.Slices);
+}
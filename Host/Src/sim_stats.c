@@ -0,0 +1,67 @@
+/*
+ * sim_stats.c
+ */
+#include "sim_stats.h"
+
+static uint32_t SIM_Hist_Bucket(uint32_t value) {
+    uint32_t msb;
+
+    if (value < 16) {
+        return value;
+    }
+    msb = 31 - (uint32_t)__builtin_clz(value);
+    return 16 + (msb - 4) * 8 + ((value >> (msb - 3)) & 7);
+}
+
+/* Largest value that falls into a bucket */
+static uint32_t SIM_Hist_Upper(uint32_t bucket) {
+    uint32_t msb, sub;
+
+    if (bucket < 16) {
+        return bucket;
+    }
+    msb = (bucket - 16) / 8 + 4;
+    sub = (bucket - 16) % 8;
+    return (uint32_t)((((uint64_t)(8 + sub + 1)) << (msb - 3)) - 1);
+}
+
+void SIM_Hist_Add(SIM_Hist* h, uint32_t value) {
+    h->Count[SIM_Hist_Bucket(value)]++;
+    h->Total++;
+    h->Sum += value;
+    if (value > h->Max) {
+        h->Max = value;
+    }
+}
+
+void SIM_Hist_Merge(SIM_Hist* dst, const SIM_Hist* src) {
+    for (uint32_t i = 0; i < SIM_HIST_BUCKETS; i++) {
+        dst->Count[i] += src->Count[i];
+    }
+    dst->Total += src->Total;
+    dst->Sum += src->Sum;
+    if (src->Max > dst->Max) {
+        dst->Max = src->Max;
+    }
+}
+
+/* pct in [0, 100]; returns an upper bound, never more than the maximum */
+uint32_t SIM_Hist_Percentile(const SIM_Hist* h, double pct) {
+    uint64_t rank, seen = 0;
+
+    if (h->Total == 0) {
+        return 0;
+    }
+    rank = (uint64_t)(pct / 100.0 * (double)h->Total);
+    if (rank >= h->Total) {
+        rank = h->Total - 1;
+    }
+    for (uint32_t i = 0; i < SIM_HIST_BUCKETS; i++) {
+        seen += h->Count[i];
+        if (seen > rank) {
+            uint32_t upper = SIM_Hist_Upper(i);
+            return upper < h->Max ? upper : h->Max;
+        }
+    }
+    return h->Max;
+}
@@ -0,0 +1,296 @@
+/*
+ * sim_timeline.c
+ *
+ * Recording, storage and comparison of simulated GPIO timelines.
+ */
+#include <stdlib.h>
+#include <string.h>
+#include "sim_timeline.h"
+
+static const char SIM_TL_MAGIC[8] = "SCHTL1";
+
+void SIM_TL_Init(SIM_Timeline* tl) {
+    memset(tl, 0, sizeof(*tl));
+}
+
+void SIM_TL_Free(SIM_Timeline* tl) {
+    free(tl->Events);
+    SIM_TL_Init(tl);
+}
+
+static void SIM_TL_Append(SIM_Timeline* tl, const SIM_TL_Event* ev) {
+    if (tl->Count == tl->Capacity) {
+        tl->Capacity = tl->Capacity ? tl->Capacity * 2 : 1024;
+        tl->Events = realloc(tl->Events, tl->Capacity * sizeof(SIM_TL_Event));
+        if (tl->Events == NULL) {
+            abort();
+        }
+    }
+    tl->Events[tl->Count++] = *ev;
+}
+
+/*----------------------------------------------------------------------------
+ * Recording
+ *---------------------------------------------------------------------------*/
+static void SIM_TL_On_GPIO(SIM_Sim* sim, uint8_t port, uint16_t changed, uint16_t odr) {
+    SIM_TL_Event ev = { SCH_Ctx_Get_Current_Tick(&sim->Sched), SIM_TL_EDGE, port, changed, odr & changed };
+
+    SIM_TL_Append((SIM_Timeline*)sim->User, &ev);
+}
+
+static void SIM_TL_On_Dispatch(SIM_Sim* sim) {
+    SIM_Timeline* tl = (SIM_Timeline*)sim->User;
+    SIM_TL_Event ev = { SCH_Ctx_Get_Current_Tick(&sim->Sched), SIM_TL_WORK, 0, 0,
+                        (uint32_t)(sim->PinOps - tl->LastPinOps) };
+
+    tl->LastPinOps = sim->PinOps;
+    SIM_TL_Append(tl, &ev);
+}
+
+void SIM_TL_Record(SIM_Timeline* tl, SIM_Sim* sim, uint32_t ticks, uint8_t mode) {
+    sim->OnGPIO = SIM_TL_On_GPIO;
+    sim->OnDispatch = SIM_TL_On_Dispatch;
+    sim->User = tl;
+    tl->LastPinOps = sim->PinOps;
+
+    SIM_Run(sim, ticks, mode);
+    tl->Ticks += ticks;
+
+    sim->OnGPIO = NULL;
+    sim->OnDispatch = NULL;
+}
+
+/*----------------------------------------------------------------------------
+ * Storage
+ *---------------------------------------------------------------------------*/
+static void SIM_TL_Put_U32(FILE* f, uint32_t v) {
+    uint8_t b[4] = { (uint8_t)v, (uint8_t)(v >> 8), (uint8_t)(v >> 16), (uint8_t)(v >> 24) };
+
+    fwrite(b, 1, 4, f);
+}
+
+static void SIM_TL_Put_Var(FILE* f, uint32_t v) {
+    while (v >= 0x80) {
+        fputc((int)(v & 0x7F) | 0x80, f);
+        v >>= 7;
+    }
+    fputc((int)v, f);
+}
+
+static int SIM_TL_Get_U32(FILE* f, uint32_t* v) {
+    uint8_t b[4];
+
+    if (fread(b, 1, 4, f) != 4) {
+        return -1;
+    }
+    *v = (uint32_t)b[0] | (uint32_t)b[1] << 8 | (uint32_t)b[2] << 16 | (uint32_t)b[3] << 24;
+    return 0;
+}
+
+static int SIM_TL_Get_Var(FILE* f, uint32_t* v) {
+    uint32_t result = 0;
+
+    for (int shift = 0; shift < 35; shift += 7) {
+        int c = fgetc(f);
+        if (c == EOF) {
+            return -1;
+        }
+        result |= (uint32_t)(c & 0x7F) << shift;
+        if ((c & 0x80) == 0) {
+            *v = result;
+            return 0;
+        }
+    }
+    return -1;
+}
+
+int SIM_TL_Save(const SIM_Timeline* tl, const char* path) {
+    FILE* f = fopen(path, "wb");
+    uint32_t tick = 0;
+
+    if (f == NULL) {
+        return -1;
+    }
+    fwrite(SIM_TL_MAGIC, 1, sizeof(SIM_TL_MAGIC), f);
+    SIM_TL_Put_U32(f, tl->Ticks);
+    SIM_TL_Put_U32(f, tl->Count);
+
+    for (uint32_t i = 0; i < tl->Count; i++) {
+        const SIM_TL_Event* ev = &tl->Events[i];
+
+        SIM_TL_Put_Var(f, ev->Tick - tick);
+        fputc(ev->Kind << 4 | ev->Port, f);
+        if (ev->Kind == SIM_TL_EDGE) {
+            SIM_TL_Put_Var(f, ev->Changed);
+        }
+        SIM_TL_Put_Var(f, ev->Value);
+        tick = ev->Tick;
+    }
+    return fclose(f) == 0 ? 0 : -1;
+}
+
+int SIM_TL_Load(SIM_Timeline* tl, const char* path) {
+    FILE* f = fopen(path, "rb");
+    char magic[sizeof(SIM_TL_MAGIC)];
+    uint32_t count, tick = 0;
+
+    SIM_TL_Init(tl);
+    if (f == NULL) {
+        return -1;
+    }
+    if (fread(magic, 1, sizeof(magic), f) != sizeof(magic) || memcmp(magic, SIM_TL_MAGIC, sizeof(magic)) != 0 ||
+        SIM_TL_Get_U32(f, &tl->Ticks) != 0 || SIM_TL_Get_U32(f, &count) != 0) {
+        fclose(f);
+        return -1;
+    }
+
+    for (uint32_t i = 0; i < count; i++) {
+        SIM_TL_Event ev = { 0 };
+        uint32_t delta, changed = 0;
+        int kind = 0;
+
+        if (SIM_TL_Get_Var(f, &delta) != 0 || (kind = fgetc(f)) == EOF ||
+            ((kind >> 4) == SIM_TL_EDGE && SIM_TL_Get_Var(f, &changed) != 0) ||
+            SIM_TL_Get_Var(f, &ev.Value) != 0) {
+            fclose(f);
+            SIM_TL_Free(tl);
+            return -1;
+        }
+        tick += delta;
+        ev.Tick = tick;
+        ev.Kind = (uint8_t)(kind >> 4);
+        ev.Port = (uint8_t)(kind & 0x0F);
+        ev.Changed = (uint16_t)changed;
+        SIM_TL_Append(tl, &ev);
+    }
+    fclose(f);
+    return 0;
+}
+
+/*----------------------------------------------------------------------------
+ * Comparison
+ *---------------------------------------------------------------------------*/
+typedef struct {
+    uint32_t Tick;
+    uint8_t Level;
+} SIM_TL_Edge;
+
+/* All edges of one pin, in time order */
+static uint32_t SIM_TL_Pin_Edges(const SIM_Timeline* tl, uint8_t port, uint16_t pin, SIM_TL_Edge* out) {
+    uint32_t n = 0;
+
+    for (uint32_t i = 0; i < tl->Count; i++) {
+        const SIM_TL_Event* ev = &tl->Events[i];
+
+        if (ev->Kind == SIM_TL_EDGE && ev->Port == port && (ev->Changed & pin)) {
+            out[n].Tick = ev->Tick;
+            out[n].Level = (ev->Value & pin) != 0;
+            n++;
+        }
+    }
+    return n;
+}
+
+static int SIM_TL_Report(FILE* out, uint32_t* printed, const SIM_TL_Options* opt) {
+    return out != NULL && (*printed)++ < opt->MaxReports;
+}
+
+/*
+ * Edges of a pin are paired in time order when they are at most
+ * DriftWindow ticks apart; the rest are missing or extra. A paired edge
+ * with the opposite level is counted as missing + extra, since that
+ * always means a toggle was lost or added earlier.
+ */
+static void SIM_TL_Diff_Pin(const SIM_TL_Edge* g, uint32_t ng, const SIM_TL_Edge* n, uint32_t nn,
+                            uint8_t port, int bit, const SIM_TL_Options* opt, SIM_TL_Result* res,
+                            FILE* out, uint32_t* printed) {
+    uint32_t i = 0, j = 0;
+
+    while (i < ng || j < nn) {
+        int64_t shift = (i < ng && j < nn) ? (int64_t)n[j].Tick - (int64_t)g[i].Tick : 0;
+
+        if (i < ng && j < nn && llabs(shift) <= (int64_t)opt->DriftWindow && g[i].Level == n[j].Level) {
+            if (shift != 0) {
+                res->Drifted++;
+                if (llabs(shift) > llabs(res->MaxDrift)) {
+                    res->MaxDrift = (int32_t)shift;
+                }
+                if (SIM_TL_Report(out, printed, opt)) {
+                    fprintf(out, "drift   P%c%-2d tick %u -> %u (%+lld)\n", 'A' + port, bit,
+                            (unsigned)g[i].Tick, (unsigned)n[j].Tick, (long long)shift);
+                }
+            }
+            i++;
+            j++;
+        } else if (j >= nn || (i < ng && g[i].Tick <= n[j].Tick)) {
+            res->Missing++;
+            if (SIM_TL_Report(out, printed, opt)) {
+                fprintf(out, "missing P%c%-2d tick %u -> %u\n", 'A' + port, bit, (unsigned)g[i].Tick, g[i].Level);
+            }
+            i++;
+        } else {
+            res->Extra++;
+            if (SIM_TL_Report(out, printed, opt)) {
+                fprintf(out, "extra   P%c%-2d tick %u -> %u\n", 'A' + port, bit, (unsigned)n[j].Tick, n[j].Level);
+            }
+            j++;
+        }
+    }
+}
+
+void SIM_TL_Diff(const SIM_Timeline* golden, const SIM_Timeline* now,
+                 const SIM_TL_Options* opt, SIM_TL_Result* res, FILE* out) {
+    SIM_TL_Edge* g = malloc((golden->Count + 1) * sizeof(SIM_TL_Edge));
+    SIM_TL_Edge* n = malloc((now->Count + 1) * sizeof(SIM_TL_Edge));
+    uint32_t printed = 0, i = 0, j = 0;
+
+    memset(res, 0, sizeof(*res));
+    if (g == NULL || n == NULL) {
+        abort();
+    }
+
+    for (uint8_t port = 0; port < SIM_GPIO_PORTS; port++) {
+        for (int bit = 0; bit < 16; bit++) {
+            uint32_t ng = SIM_TL_Pin_Edges(golden, port, (uint16_t)(1u << bit), g);
+            uint32_t nn = SIM_TL_Pin_Edges(now, port, (uint16_t)(1u << bit), n);
+
+            SIM_TL_Diff_Pin(g, ng, n, nn, port, bit, opt, res, out, &printed);
+        }
+    }
+
+    // Work per dispatch, matched by tick
+    printed = 0;
+    while (i < golden->Count || j < now->Count) {
+        const SIM_TL_Event* ge = (i < golden->Count) ? &golden->Events[i] : NULL;
+        const SIM_TL_Event* ne = (j < now->Count) ? &now->Events[j] : NULL;
+        uint32_t tick, gw = 0, nw = 0;
+
+        if (ge != NULL && ge->Kind != SIM_TL_WORK) {
+            i++;
+            continue;
+        }
+        if (ne != NULL && ne->Kind != SIM_TL_WORK) {
+            j++;
+            continue;
+        }
+        tick = (ne == NULL || (ge != NULL && ge->Tick <= ne->Tick)) ? ge->Tick : ne->Tick;
+        if (ge != NULL && ge->Tick == tick) {
+            gw = ge->Value + 1;     // +1: a dispatch happened at all
+            i++;
+        }
+        if (ne != NULL && ne->Tick == tick) {
+            nw = ne->Value + 1;
+            j++;
+        }
+        if (gw != nw) {
+            res->WorkChanged++;
+            if (SIM_TL_Report(out, &printed, opt)) {
+                fprintf(out, "work    tick %u: %s%u -> %s%u GPIO calls\n", (unsigned)tick,
+                        gw ? "" : "idle ", gw ? gw - 1 : 0, nw ? "" : "idle ", nw ? nw - 1 : 0);
+            }
+        }
+    }
+
+    free(g);
+    free(n);
+}
@@ -0,0 +1,164 @@
+/*
+ * sim_timing.c
+ */
+#include <math.h>
+#include <stddef.h>
+#include <string.h>
+#include "sim_timing.h"
+
+/* splitmix64 */
+uint64_t SIM_Rand(uint64_t* state) {
+    uint64_t z = (*state += 0x9E3779B97F4A7C15ull);
+
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+double SIM_Rand_Unit(uint64_t* state) {
+    return (double)(SIM_Rand(state) >> 11) * (1.0 / 9007199254740992.0);
+}
+
+static uint32_t SIM_Sample_Exec(SIM_Device* dev, const SIM_TaskSpec* spec) {
+    double u, v;
+
+    switch (spec->ExecKind) {
+    case SIM_EXEC_UNIFORM:
+        if (spec->ExecB <= spec->ExecA) {
+            return spec->ExecA;
+        }
+        return spec->ExecA + (uint32_t)(SIM_Rand(&dev->Rng) % (spec->ExecB - spec->ExecA + 1));
+    case SIM_EXEC_NORMAL:
+        // Box-Muller
+        u = SIM_Rand_Unit(&dev->Rng);
+        v = SIM_Rand_Unit(&dev->Rng);
+        u = spec->ExecA + spec->ExecB * sqrt(-2.0 * log(1.0 - u)) * cos(6.283185307179586 * v);
+        return u > 0 ? (uint32_t)u : 0;
+    case SIM_EXEC_BIMODAL:
+        return (SIM_Rand(&dev->Rng) % 100 == 0) ? spec->ExecB : spec->ExecA;
+    default:
+        return spec->ExecA;
+    }
+}
+
+/* Let CPU time pass, delivering the timer interrupts that fall into it */
+static void SIM_Consume(SIM_Device* dev, uint64_t us) {
+    while (us > 0) {
+        uint64_t room = dev->NextTick - dev->Now;
+        uint64_t use = us < room ? us : room;
+
+        dev->Now += use;
+        dev->TickBusy += (uint32_t)use;
+        us -= use;
+
+        if (dev->Now == dev->NextTick) {
+            if (dev->TickBusy > dev->PeakTickBusy) {
+                dev->PeakTickBusy = dev->TickBusy;
+            }
+            dev->TickBusy = 0;
+            if (SCH_Ctx_Get_Ticks_To_Next(&dev->Sched) == 0) {
+                dev->LostTicks++;
+            } else {
+                dev->ReleaseTime = dev->NextTick;
+            }
+            dev->NextTick += SIM_TICK_US;
+            SCH_Ctx_Update(&dev->Sched);
+        }
+    }
+}
+
+static void SIM_Job_Run(void* arg) {
+    SIM_TimingTask* task = (SIM_TimingTask*)arg;
+    SIM_Device* dev = task->Device;
+    uint64_t release = dev->ReleaseTime;
+    uint32_t exec = SIM_Sample_Exec(dev, &task->Spec);
+    uint64_t response;
+
+    SIM_Consume(dev, exec);
+    dev->Busy += exec;
+
+    response = dev->Now - release;
+    if (response > UINT32_MAX) {
+        response = UINT32_MAX;
+    }
+    if (task->Spec.Period > 0 && response > (uint64_t)task->Spec.Period * SIM_TICK_US) {
+        task->Misses++;
+    }
+    if (response > task->MaxResponse) {
+        task->MaxResponse = (uint32_t)response;
+    }
+    if (task->Response != NULL) {
+        SIM_Hist_Add(task->Response, (uint32_t)response);
+    }
+    if (dev->Response != NULL) {
+        SIM_Hist_Add(dev->Response, (uint32_t)response);
+    }
+    task->Jobs++;
+}
+
+void SIM_Device_Init(SIM_Device* dev, const SIM_TaskSpec* specs, SIM_TimingTask* tasks,
+                     uint32_t numTasks, uint64_t seed) {
+    memset(&dev->Sched, 0, sizeof(dev->Sched));
+    SCH_Ctx_Init(&dev->Sched);
+    dev->Tasks = tasks;
+    dev->NumTasks = numTasks;
+    dev->Rng = seed;
+    dev->Now = 0;
+    dev->NextTick = SIM_TICK_US;
+    dev->Busy = 0;
+    dev->TickBusy = 0;
+    dev->PeakTickBusy = 0;
+    dev->ReleaseTime = 0;
+    dev->LostTicks = 0;
+    dev->Response = NULL;
+
+    for (uint32_t i = 0; i < numTasks; i++) {
+        tasks[i].Spec = specs[i];
+        tasks[i].Device = dev;
+        tasks[i].Jobs = 0;
+        tasks[i].Misses = 0;
+        tasks[i].MaxResponse = 0;
+        tasks[i].Response = NULL;
+        SCH_Ctx_Add_Task_Arg(&dev->Sched, SIM_Job_Run, &tasks[i], specs[i].Offset, specs[i].Period);
+    }
+}
+
+/* Simulate until the timer has fired 'ticks' more times */
+void SIM_Device_Run(SIM_Device* dev, uint32_t ticks) {
+    uint64_t end = dev->NextTick + ((uint64_t)ticks - 1) * SIM_TICK_US;
+
+    if (ticks == 0) {
+        return;
+    }
+    for (;;) {
+        uint64_t left;
+        uint32_t idle;
+
+        SCH_Ctx_Dispatch_Tasks(&dev->Sched);
+        if (dev->NextTick > end) {
+            break;
+        }
+
+        // CPU idle: close the current tick and skip to the next deadline
+        if (dev->TickBusy > dev->PeakTickBusy) {
+            dev->PeakTickBusy = dev->TickBusy;
+        }
+        dev->TickBusy = 0;
+
+        idle = SCH_Ctx_Get_Ticks_To_Next(&dev->Sched);
+        left = (end - dev->NextTick) / SIM_TICK_US + 1;
+        if (idle == 0) {
+            idle = 1;
+        } else if (idle > left) {
+            idle = (uint32_t)left;
+        }
+        SCH_Ctx_Advance(&dev->Sched, idle);
+        dev->Now = dev->NextTick + ((uint64_t)idle - 1) * SIM_TICK_US;
+        dev->NextTick = dev->Now + SIM_TICK_US;
+        dev->ReleaseTime = dev->Now;
+    }
+}
+
+void SIM_Device_Free(SIM_Device* dev) {
+    SCH_Ctx_Deinit(&dev->Sched);
+}
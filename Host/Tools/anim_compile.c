@@ -0,0 +1,99 @@
+/*
+ * anim_compile.c
+ *
+ * Build-time compiler for LED animation patterns (Core/Inc/anim.h).
+ * Turns keyframes given on the command line into a const delta timeline
+ * that can be pasted into (or generated as) a firmware source file, so
+ * the pattern lives in flash and costs no RAM or compile time on target.
+ *
+ *   anim_compile [-t tickMs] [-l loopMs] name time:level[:f] ...
+ *
+ *   -t   scheduler tick in ms (default 10)
+ *   -l   pattern length for looping, 0 = play once (default 0)
+ *   :f   fade from the previous keyframe instead of a jump
+ *
+ * Example (breathing, 2 s):
+ *   anim_compile -l 2000 breathe 0:0 1000:255:f 2000:0:f > breathe.h
+ *
+ * Build from the repository root:
+ *   gcc -O2 -ICore/Inc Host/Tools/anim_compile.c Core/Src/anim.c Core/Src/scheduler.c -o anim_compile
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "anim.h"
+
+#define MAX_FRAMES  256
+#define MAX_STEPS   4096
+
+static int Usage(void) {
+    fprintf(stderr, "usage: anim_compile [-t tickMs] [-l loopMs] name time:level[:f] ...\n");
+    return 2;
+}
+
+int main(int argc, char** argv) {
+    static ANIM_Keyframe frames[MAX_FRAMES];
+    static ANIM_Step steps[MAX_STEPS];
+    ANIM_Timeline timeline;
+    unsigned tickMs = 10;
+    unsigned loopMs = 0;
+    uint16_t count = 0;
+    const char* name;
+    int i = 1;
+
+    for (; i < argc && argv[i][0] == '-'; i++) {
+        if (i + 1 >= argc) {
+            return Usage();
+        }
+        if (strcmp(argv[i], "-t") == 0) {
+            tickMs = (unsigned)strtoul(argv[++i], NULL, 0);
+        } else if (strcmp(argv[i], "-l") == 0) {
+            loopMs = (unsigned)strtoul(argv[++i], NULL, 0);
+        } else {
+            return Usage();
+        }
+    }
+    if (i >= argc || tickMs == 0) {
+        return Usage();
+    }
+    name = argv[i++];
+
+    for (; i < argc; i++) {
+        unsigned t;
+        unsigned level;
+        char fade = 0;
+
+        if (count >= MAX_FRAMES || sscanf(argv[i], "%u:%u:%c", &t, &level, &fade) < 2 || level > 255 ||
+            t > 0xFFFF || (count > 0 && t < frames[count - 1].TimeMs)) {
+            fprintf(stderr, "anim_compile: bad keyframe '%s'\n", argv[i]);
+            return 1;
+        }
+        frames[count].TimeMs = (uint16_t)t;
+        frames[count].Level = (uint8_t)level;
+        frames[count].Fade = (fade == 'f');
+        count++;
+    }
+    if (count == 0) {
+        return Usage();
+    }
+
+    // Same checks as ANIM_Compile(), to tell the causes of a 0 apart
+    if (loopMs != 0 && (loopMs / tickMs == 0 || loopMs / tickMs < frames[count - 1].TimeMs / tickMs)) {
+        fprintf(stderr, "anim_compile: loop of %u ms is shorter than the last keyframe or one tick\n", loopMs);
+        return 1;
+    }
+    if (ANIM_Compile(frames, count, (uint16_t)loopMs, (uint16_t)tickMs, steps, MAX_STEPS, &timeline) == 0) {
+        fprintf(stderr, "anim_compile: more than %u steps\n", (unsigned)MAX_STEPS);
+        return 1;
+    }
+
+    printf("/* Generated by anim_compile: %u keyframes, %u ms tick */\n", (unsigned)count, tickMs);
+    printf("static const ANIM_Step %s_Steps[%u] = {\n", name, (unsigned)timeline.Count);
+    for (uint16_t s = 0; s < timeline.Count; s++) {
+        printf("    { %u, %u },\n", (unsigned)steps[s].Delta, (unsigned)steps[s].Level);
+    }
+    printf("};\n");
+    printf("static const ANIM_Timeline %s = { %s_Steps, %u, %u };\n", name, name, (unsigned)timeline.Count,
+           (unsigned)timeline.LoopTicks);
+    return 0;
+}
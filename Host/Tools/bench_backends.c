@@ -0,0 +1,132 @@
+/*
+ * bench_backends.c
+ *
+ * Compare the delta-list scheduler (scheduler.c) with the structure-of-
+ * arrays backend (scheduler_soa.c) for growing task counts: cost of adding
+ * tasks, of one timer tick (update + dispatch) and of deleting tasks.
+ *
+ *   bench_backends [ticks]
+ *
+ * Build from the repository root (drop -mavx2 to measure the SSE2 path):
+ *   gcc -O2 -mavx2 -ICore/Inc Host/Tools/bench_backends.c
+ *       Core/Src/scheduler.c Core/Src/scheduler_soa.c -o bench_backends
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "scheduler.h"
+#include "scheduler_soa.h"
+
+/* Beyond this the list's O(n) insertion makes a run take minutes */
+#define LIST_MAX_TASKS  8192
+
+static volatile uint32_t g_Sink;
+
+static void Bench_Task(void) {
+    g_Sink++;
+}
+
+static double Now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+static uint32_t Rand(uint32_t* state) {
+    *state ^= *state << 13;
+    *state ^= *state >> 17;
+    *state ^= *state << 5;
+    return *state;
+}
+
+/* Periods 1..1000 ticks, log-uniform so that short periods are common */
+static void Make_Set(uint32_t n, uint32_t* delay, uint32_t* period, uint32_t* order) {
+    uint32_t rng = 2463534242u;
+
+    for (uint32_t i = 0; i < n; i++) {
+        uint32_t p = 1u << (Rand(&rng) % 10);
+        period[i] = p + Rand(&rng) % p;
+        delay[i] = Rand(&rng) % period[i];
+        order[i] = i;
+    }
+    for (uint32_t i = n - 1; i > 0; i--) {
+        uint32_t j = Rand(&rng) % (i + 1), t = order[i];
+        order[i] = order[j];
+        order[j] = t;
+    }
+}
+
+static void Bench_List(uint32_t n, uint32_t ticks, const uint32_t* delay, const uint32_t* period,
+                       const uint32_t* order, uint32_t* ids) {
+    SCH_Context ctx = { 0 };
+    double t0, t1, t2, t3;
+
+    SCH_Ctx_Init(&ctx);
+    t0 = Now_ns();
+    for (uint32_t i = 0; i < n; i++) {
+        ids[i] = SCH_Ctx_Add_Task(&ctx, Bench_Task, delay[i], period[i]);
+    }
+    t1 = Now_ns();
+    for (uint32_t t = 0; t < ticks; t++) {
+        SCH_Ctx_Update(&ctx);
+        SCH_Ctx_Dispatch_Tasks(&ctx);
+    }
+    t2 = Now_ns();
+    for (uint32_t i = 0; i < n; i++) {
+        SCH_Ctx_Delete_Task(&ctx, ids[order[i]]);
+    }
+    t3 = Now_ns();
+
+    printf("list   %7u %12.1f %12.1f %12.1f\n", n, (t1 - t0) / n, (t2 - t1) / ticks, (t3 - t2) / n);
+}
+
+static void Bench_SoA(uint32_t n, uint32_t ticks, const uint32_t* delay, const uint32_t* period,
+                      const uint32_t* order, uint32_t* ids) {
+    SCH_SoA_Context ctx;
+    uint32_t* mem = malloc(SCH_SOA_MEM_WORDS(n) * sizeof(uint32_t));
+    double t0, t1, t2, t3;
+
+    SCH_SoA_Init(&ctx, mem, n);
+    t0 = Now_ns();
+    for (uint32_t i = 0; i < n; i++) {
+        ids[i] = SCH_SoA_Add_Task(&ctx, Bench_Task, delay[i], period[i]);
+    }
+    t1 = Now_ns();
+    for (uint32_t t = 0; t < ticks; t++) {
+        SCH_SoA_Update(&ctx);
+        SCH_SoA_Dispatch_Tasks(&ctx);
+    }
+    t2 = Now_ns();
+    for (uint32_t i = 0; i < n; i++) {
+        SCH_SoA_Delete_Task(&ctx, ids[order[i]]);
+    }
+    t3 = Now_ns();
+
+    printf("soa    %7u %12.1f %12.1f %12.1f\n", n, (t1 - t0) / n, (t2 - t1) / ticks, (t3 - t2) / n);
+    free(mem);
+}
+
+int main(int argc, char** argv) {
+    static const uint32_t sizes[] = { 16, 128, 1024, 8192, 131072 };
+    uint32_t ticks = argc > 1 ? (uint32_t)strtoul(argv[1], NULL, 0) : 2000;
+    uint32_t max = sizes[sizeof(sizes) / sizeof(sizes[0]) - 1];
+    uint32_t* delay = malloc(max * sizeof(uint32_t));
+    uint32_t* period = malloc(max * sizeof(uint32_t));
+    uint32_t* order = malloc(max * sizeof(uint32_t));
+    uint32_t* ids = malloc(max * sizeof(uint32_t));
+
+    printf("%-6s %7s %12s %12s %12s\n", "", "tasks", "add ns/op", "tick ns", "delete ns/op");
+    for (uint32_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+        Make_Set(sizes[s], delay, period, order);
+        if (sizes[s] <= LIST_MAX_TASKS) {
+            Bench_List(sizes[s], ticks, delay, period, order, ids);
+        }
+        Bench_SoA(sizes[s], ticks, delay, period, order, ids);
+    }
+
+    free(ids);
+    free(order);
+    free(period);
+    free(delay);
+    return 0;
+}
@@ -0,0 +1,202 @@
+/*
+ * fleet_sim.c
+ *
+ * Predict the timing behaviour of a fleet of devices offline. Every device
+ * gets its own randomly generated task set, scheduler context and virtual
+ * clock; devices are simulated in parallel on a work-stealing pool and the
+ * per-worker statistics are merged at the end.
+ *
+ *   fleet_sim [-n devices] [-s seconds] [-j threads] [-r seed]
+ *
+ * Build from the repository root:
+ *   gcc -O2 -pthread -IHost/Inc -ICore/Inc Host/Tools/fleet_sim.c
+ *       Host/Src/sim_timing.c Host/Src/sim_pool.c Host/Src/sim_stats.c
+ *       Core/Src/scheduler.c -lm -o fleet_sim
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "sim_pool.h"
+#include "sim_timing.h"
+
+#define MAX_TASKS       12
+#define UTIL_BINS       10
+
+typedef struct {
+    SIM_Hist Latency;               // Response times of all jobs, us
+    uint64_t Jobs;
+    uint64_t Misses;
+    uint64_t Busy;                  // us
+    uint64_t Devices[UTIL_BINS];    // Devices per 10% utilization bin
+    uint64_t Missing[UTIL_BINS];    // ... of which missed a deadline
+    uint32_t PeakTickBusy;          // us
+    uint64_t LostTicks;
+    uint32_t MaxLostTicks;
+    char Pad[64];
+} Worker_Stats;
+
+typedef struct {
+    uint32_t Ticks;
+    uint64_t Seed;
+    Worker_Stats* Stats;
+} Fleet;
+
+static const uint32_t g_Periods[] = { 1, 2, 5, 10, 20, 25, 50, 100, 200, 500 };
+
+/*
+ * Random task set aiming at a total utilization between 5% and 95%. Mean
+ * execution time is capped at 30% of a tick, as a cooperative scheduler
+ * cannot absorb longer jobs; rare outliers may still span a tick.
+ */
+static uint32_t Fleet_Make_Tasks(uint64_t* rng, SIM_TaskSpec* specs) {
+    uint32_t n = 3 + (uint32_t)(SIM_Rand(rng) % (MAX_TASKS - 2));
+    double target = 0.05 + 0.90 * SIM_Rand_Unit(rng);
+    double share[MAX_TASKS], total = 0;
+
+    for (uint32_t i = 0; i < n; i++) {
+        share[i] = 0.1 + SIM_Rand_Unit(rng);
+        total += share[i];
+    }
+    for (uint32_t i = 0; i < n; i++) {
+        uint32_t period = g_Periods[SIM_Rand(rng) % (sizeof(g_Periods) / sizeof(g_Periods[0]))];
+        double mean = target * share[i] / total * period * SIM_TICK_US;
+
+        if (mean > 0.3 * SIM_TICK_US) {
+            mean = 0.3 * SIM_TICK_US;
+        }
+
+        specs[i].Period = period;
+        specs[i].Offset = (uint32_t)(SIM_Rand(rng) % period);
+        if (SIM_Rand(rng) % 8 == 0) {
+            specs[i].ExecKind = SIM_EXEC_BIMODAL;
+            specs[i].ExecA = (uint32_t)(mean * 0.9);
+            specs[i].ExecB = (uint32_t)(mean * 10 < 1.5 * SIM_TICK_US ? mean * 10 : 1.5 * SIM_TICK_US);
+        } else {
+            specs[i].ExecKind = SIM_EXEC_UNIFORM;
+            specs[i].ExecA = (uint32_t)(mean * 0.5);
+            specs[i].ExecB = (uint32_t)(mean * 1.5);
+        }
+    }
+    return n;
+}
+
+static void Fleet_Job(uint32_t job, uint32_t worker, void* user) {
+    Fleet* fleet = (Fleet*)user;
+    Worker_Stats* st = &fleet->Stats[worker];
+    SIM_TaskSpec specs[MAX_TASKS];
+    SIM_TimingTask tasks[MAX_TASKS];
+    SIM_Device dev;
+    uint64_t rng = fleet->Seed ^ ((uint64_t)job * 0x2545F4914F6CDD1Dull);
+    uint32_t n = Fleet_Make_Tasks(&rng, specs);
+    uint64_t misses = 0;
+    uint32_t bin;
+
+    SIM_Device_Init(&dev, specs, tasks, n, rng);
+    dev.Response = &st->Latency;
+    SIM_Device_Run(&dev, fleet->Ticks);
+
+    for (uint32_t i = 0; i < n; i++) {
+        st->Jobs += tasks[i].Jobs;
+        misses += tasks[i].Misses;
+    }
+    st->Misses += misses;
+    st->Busy += dev.Busy;
+    st->LostTicks += dev.LostTicks;
+    if (dev.LostTicks > st->MaxLostTicks) {
+        st->MaxLostTicks = dev.LostTicks;
+    }
+    if (dev.PeakTickBusy > st->PeakTickBusy) {
+        st->PeakTickBusy = dev.PeakTickBusy;
+    }
+
+    bin = (uint32_t)(dev.Busy * UTIL_BINS / ((uint64_t)fleet->Ticks * SIM_TICK_US));
+    if (bin >= UTIL_BINS) {
+        bin = UTIL_BINS - 1;
+    }
+    st->Devices[bin]++;
+    if (misses > 0) {
+        st->Missing[bin]++;
+    }
+
+    SIM_Device_Free(&dev);
+}
+
+int main(int argc, char** argv) {
+    uint32_t devices = 10000, threads = 0;
+    double seconds = 3600;
+    Fleet fleet = { 0, 1, NULL };
+    Worker_Stats total;
+    struct timespec t0, t1;
+    double wall;
+
+    for (int i = 1; i + 1 < argc; i += 2) {
+        if (strcmp(argv[i], "-n") == 0) {
+            devices = (uint32_t)strtoul(argv[i + 1], NULL, 0);
+        } else if (strcmp(argv[i], "-s") == 0) {
+            seconds = atof(argv[i + 1]);
+        } else if (strcmp(argv[i], "-j") == 0) {
+            threads = (uint32_t)strtoul(argv[i + 1], NULL, 0);
+        } else if (strcmp(argv[i], "-r") == 0) {
+            fleet.Seed = strtoull(argv[i + 1], NULL, 0);
+        } else {
+            fprintf(stderr, "usage: %s [-n devices] [-s seconds] [-j threads] [-r seed]\n", argv[0]);
+            return 2;
+        }
+    }
+    if (threads == 0) {
+        threads = SIM_Pool_Default_Threads();
+    }
+
+    fleet.Ticks = (uint32_t)(seconds * 1000000 / SIM_TICK_US);
+    fleet.Stats = calloc(threads, sizeof(Worker_Stats));
+
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    SIM_Pool_Run(devices, threads, Fleet_Job, &fleet);
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    wall = (double)(t1.tv_sec - t0.tv_sec) + (double)(t1.tv_nsec - t0.tv_nsec) * 1e-9;
+
+    memset(&total, 0, sizeof(total));
+    for (uint32_t w = 0; w < threads; w++) {
+        Worker_Stats* st = &fleet.Stats[w];
+
+        SIM_Hist_Merge(&total.Latency, &st->Latency);
+        total.Jobs += st->Jobs;
+        total.Misses += st->Misses;
+        total.Busy += st->Busy;
+        total.LostTicks += st->LostTicks;
+        if (st->MaxLostTicks > total.MaxLostTicks) {
+            total.MaxLostTicks = st->MaxLostTicks;
+        }
+        for (uint32_t b = 0; b < UTIL_BINS; b++) {
+            total.Devices[b] += st->Devices[b];
+            total.Missing[b] += st->Missing[b];
+        }
+        if (st->PeakTickBusy > total.PeakTickBusy) {
+            total.PeakTickBusy = st->PeakTickBusy;
+        }
+    }
+
+    printf("devices            %u x %.0f s on %u threads in %.2f s (%.0f device-hours/s)\n",
+           devices, seconds, threads, wall, devices * seconds / 3600.0 / wall);
+    printf("jobs               %llu\n", (unsigned long long)total.Jobs);
+    printf("deadline misses    %llu (%.4f%%)\n", (unsigned long long)total.Misses,
+           total.Jobs ? 100.0 * (double)total.Misses / (double)total.Jobs : 0.0);
+    printf("mean utilization   %.1f%%\n",
+           100.0 * (double)total.Busy / ((double)devices * fleet.Ticks * SIM_TICK_US));
+    printf("peak tick load     %.1f%%\n", 100.0 * total.PeakTickBusy / SIM_TICK_US);
+    printf("lost ticks         %.1f per device, worst %u\n",
+           (double)total.LostTicks / devices, total.MaxLostTicks);
+    printf("response time us   p50 %u  p90 %u  p99 %u  p99.9 %u  max %u\n",
+           SIM_Hist_Percentile(&total.Latency, 50), SIM_Hist_Percentile(&total.Latency, 90),
+           SIM_Hist_Percentile(&total.Latency, 99), SIM_Hist_Percentile(&total.Latency, 99.9),
+           total.Latency.Max);
+    printf("utilization   devices   with misses\n");
+    for (uint32_t b = 0; b < UTIL_BINS; b++) {
+        printf("  %3u-%3u%%   %8llu   %8llu\n", b * 100 / UTIL_BINS, (b + 1) * 100 / UTIL_BINS,
+               (unsigned long long)total.Devices[b], (unsigned long long)total.Missing[b]);
+    }
+
+    free(fleet.Stats);
+    return 0;
+}
@@ -0,0 +1,586 @@
+/*
+ * fuzz_backends.c
+ *
+ * Differential fuzzer for the scheduler backends. The input bytes are
+ * decoded into a sequence of add/delete/update/advance/dispatch calls that
+ * is applied to a plain reference model, to the delta list (scheduler.c)
+ * and to the SoA backend (scheduler_soa.c). Tasks may delete, add or tick
+ * from inside their callback. After every call the dispatch order, tick of
+ * every run, return values and ticks-to-next must be identical; any
+ * difference prints the call history and aborts, so the fuzzer keeps the
+ * input as a crash.
+ *
+ * Each call is also timed (TSC cycles on x86, ns elsewhere). Calls that
+ * cost far more than the running mean for that backend and operation are
+ * kept and listed at exit, with the task count at the time.
+ *
+ * libFuzzer:
+ *   clang -O1 -g -fsanitize=fuzzer,address -DSCH_FUZZ_LIBFUZZER -ICore/Inc
+ *       Host/Tools/fuzz_backends.c Core/Src/scheduler.c Core/Src/scheduler_soa.c
+ *       -o fuzz_backends && ./fuzz_backends corpus/
+ * AFL (or plain replay of crash files):
+ *   afl-gcc -O1 -ICore/Inc Host/Tools/fuzz_backends.c Core/Src/scheduler.c
+ *       Core/Src/scheduler_soa.c -o fuzz_backends
+ *   afl-fuzz -i seeds -o out -- ./fuzz_backends @@
+ * Standalone random run:
+ *   fuzz_backends -r iterations [-s seed]
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "scheduler.h"
+#include "scheduler_soa.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define FUZZ_COST_UNIT  "cycles"
+static inline uint64_t Fuzz_Cycles(void) {
+    return __rdtsc();
+}
+#else
+#define FUZZ_COST_UNIT  "ns"
+static inline uint64_t Fuzz_Cycles(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+#endif
+
+#define FUZZ_MAX_TASKS      256     // Logical tasks per input
+#define FUZZ_MAX_OPS        4096    // Calls per input
+#define FUZZ_HISTORY        32      // Calls printed on a mismatch
+#define FUZZ_TRACE_WORDS    8192
+#define FUZZ_BACKENDS       3
+#define FUZZ_OUTLIERS       8       // Kept per backend and operation
+#define FUZZ_OUTLIER_FACTOR 20      // Times the mean
+#define FUZZ_OUTLIER_MIN    2000    // Ignore anything cheaper
+
+/* Operations */
+enum { OP_ADD, OP_DELETE, OP_UPDATE, OP_ADVANCE, OP_DISPATCH, OP_COUNT };
+static const char* const g_OpNames[OP_COUNT] = { "add", "delete", "update", "advance", "dispatch" };
+
+/* What a task does when it runs */
+enum { ACT_NONE, ACT_DELETE, ACT_ADD, ACT_UPDATE };
+
+typedef struct {
+    uint8_t Kind;
+    uint32_t Param;
+} Fuzz_Action;
+
+/*----------------------------------------------------------------------------
+ * Reference Model - obviously correct, O(n) everything
+ *
+ * Tasks hold absolute deadlines on a virtual clock that only advances
+ * while no task is due; the next task to run is the one with the smallest
+ * (deadline, insertion sequence). This is the documented behavior of the
+ * delta list, without the delta encoding.
+ *---------------------------------------------------------------------------*/
+typedef struct {
+    uint64_t Deadline;
+    uint64_t Seq;
+    uint32_t Period;
+    uint32_t ID;
+    void* Arg;
+} Ref_Task;
+
+typedef struct {
+    Ref_Task Tasks[FUZZ_MAX_TASKS];
+    uint32_t Count;
+    uint64_t Now;                   // Virtual time
+    uint64_t NextSeq;
+    uint32_t NextID;
+    uint32_t CurrentTick;
+    void (*Func)(void*);
+} Ref_Model;
+
+static int Ref_Earliest(const Ref_Model* m) {
+    int best = -1;
+
+    for (uint32_t i = 0; i < m->Count; i++) {
+        const Ref_Task* t = &m->Tasks[i];
+        if (best < 0 || t->Deadline < m->Tasks[best].Deadline ||
+            (t->Deadline == m->Tasks[best].Deadline && t->Seq < m->Tasks[best].Seq)) {
+            best = (int)i;
+        }
+    }
+    return best;
+}
+
+static void Ref_Insert(Ref_Model* m, Ref_Task* t, uint32_t delay) {
+    t->Deadline = m->Now + delay;
+    t->Seq = m->NextSeq++;
+    m->Tasks[m->Count++] = *t;
+}
+
+static uint32_t Ref_Add(Ref_Model* m, void* arg, uint32_t delay, uint32_t period) {
+    Ref_Task t = { 0, 0, period, m->NextID++, arg };
+
+    if (m->Count == FUZZ_MAX_TASKS) {
+        return NO_TASK_ID;
+    }
+    Ref_Insert(m, &t, delay);
+    return t.ID;
+}
+
+static uint8_t Ref_Delete(Ref_Model* m, uint32_t id) {
+    for (uint32_t i = 0; i < m->Count; i++) {
+        if (m->Tasks[i].ID == id) {
+            m->Tasks[i] = m->Tasks[--m->Count];
+            return 1;
+        }
+    }
+    return 0;
+}
+
+static uint32_t Ref_Ticks_To_Next(const Ref_Model* m) {
+    int i = Ref_Earliest(m);
+    return (i < 0) ? SCH_NO_DEADLINE : (uint32_t)(m->Tasks[i].Deadline - m->Now);
+}
+
+static void Ref_Advance(Ref_Model* m, uint32_t ticks) {
+    uint32_t next = Ref_Ticks_To_Next(m);
+
+    m->CurrentTick += ticks;
+    if (m->Count > 0) {
+        m->Now += (ticks < next) ? ticks : next;
+    }
+}
+
+static void Ref_Dispatch(Ref_Model* m) {
+    int i;
+
+    while ((i = Ref_Earliest(m)) >= 0 && m->Tasks[i].Deadline <= m->Now) {
+        Ref_Task t = m->Tasks[i];
+
+        m->Tasks[i] = m->Tasks[--m->Count];     // Off the list while running
+        m->Func(t.Arg);
+        if (t.Period > 0) {
+            Ref_Insert(m, &t, t.Period);
+        }
+    }
+}
+
+/*----------------------------------------------------------------------------
+ * Backends under test
+ *---------------------------------------------------------------------------*/
+typedef struct Fuzz_Backend Fuzz_Backend;
+
+struct Fuzz_Backend {
+    const char* Name;
+    void* Ctx;
+    uint32_t (*Add)(void* ctx, void (*fn)(void*), void* arg, uint32_t delay, uint32_t period);
+    uint8_t (*Delete)(void* ctx, uint32_t id);
+    void (*Advance)(void* ctx, uint32_t ticks);
+    void (*Dispatch)(void* ctx);
+    uint32_t (*Ticks_To_Next)(void* ctx);
+    uint32_t (*Tick)(void* ctx);
+
+    uint32_t IDs[FUZZ_MAX_TASKS];   // Logical task -> backend task ID
+    uint32_t Periods[FUZZ_MAX_TASKS];
+    uint32_t NumLogical;
+    uint32_t Live;                  // Tasks currently scheduled
+    uint32_t Trace[FUZZ_TRACE_WORDS];
+    uint32_t TraceLen;
+    uint32_t Budget;                // Callback actions left in this call
+};
+
+static Ref_Model g_Ref;
+static SCH_Context g_List;
+static SCH_SoA_Context g_SoA;
+static uint32_t g_SoAMem[SCH_SOA_MEM_WORDS(FUZZ_MAX_TASKS)];
+static Fuzz_Backend g_Backends[FUZZ_BACKENDS];
+static Fuzz_Backend* g_Current;     // Backend whose callbacks are running
+static Fuzz_Action g_Actions[FUZZ_MAX_TASKS];
+
+static uint32_t Ref_Add_Fn(void* c, void (*fn)(void*), void* arg, uint32_t d, uint32_t p) {
+    ((Ref_Model*)c)->Func = fn;
+    return Ref_Add(c, arg, d, p);
+}
+static uint8_t Ref_Delete_Fn(void* c, uint32_t id) { return Ref_Delete(c, id); }
+static void Ref_Advance_Fn(void* c, uint32_t n) { Ref_Advance(c, n); }
+static void Ref_Dispatch_Fn(void* c) { Ref_Dispatch(c); }
+static uint32_t Ref_Next_Fn(void* c) { return Ref_Ticks_To_Next(c); }
+static uint32_t Ref_Tick_Fn(void* c) { return ((Ref_Model*)c)->CurrentTick; }
+
+static uint32_t List_Add_Fn(void* c, void (*fn)(void*), void* arg, uint32_t d, uint32_t p) {
+    return SCH_Ctx_Add_Task_Arg(c, fn, arg, d, p);
+}
+static uint8_t List_Delete_Fn(void* c, uint32_t id) { return SCH_Ctx_Delete_Task(c, id); }
+static void List_Advance_Fn(void* c, uint32_t n) {
+    if (n == 1) {
+        SCH_Ctx_Update(c);          // Exercise the ISR path too
+    } else {
+        SCH_Ctx_Advance(c, n);
+    }
+}
+static void List_Dispatch_Fn(void* c) { SCH_Ctx_Dispatch_Tasks(c); }
+static uint32_t List_Next_Fn(void* c) { return SCH_Ctx_Get_Ticks_To_Next(c); }
+static uint32_t List_Tick_Fn(void* c) { return SCH_Ctx_Get_Current_Tick(c); }
+
+static uint32_t SoA_Add_Fn(void* c, void (*fn)(void*), void* arg, uint32_t d, uint32_t p) {
+    return SCH_SoA_Add_Task_Arg(c, fn, arg, d, p);
+}
+static uint8_t SoA_Delete_Fn(void* c, uint32_t id) { return SCH_SoA_Delete_Task(c, id); }
+static void SoA_Advance_Fn(void* c, uint32_t n) {
+    if (n == 1) {
+        SCH_SoA_Update(c);
+    } else {
+        SCH_SoA_Advance(c, n);
+    }
+}
+static void SoA_Dispatch_Fn(void* c) { SCH_SoA_Dispatch_Tasks(c); }
+static uint32_t SoA_Next_Fn(void* c) { return SCH_SoA_Get_Ticks_To_Next(c); }
+static uint32_t SoA_Tick_Fn(void* c) { return SCH_SoA_Get_Current_Tick(c); }
+
+static const Fuzz_Backend g_BackendTemplates[FUZZ_BACKENDS] = {
+    { .Name = "reference", .Ctx = &g_Ref, .Add = Ref_Add_Fn, .Delete = Ref_Delete_Fn, .Advance = Ref_Advance_Fn,
+      .Dispatch = Ref_Dispatch_Fn, .Ticks_To_Next = Ref_Next_Fn, .Tick = Ref_Tick_Fn },
+    { .Name = "list", .Ctx = &g_List, .Add = List_Add_Fn, .Delete = List_Delete_Fn, .Advance = List_Advance_Fn,
+      .Dispatch = List_Dispatch_Fn, .Ticks_To_Next = List_Next_Fn, .Tick = List_Tick_Fn },
+    { .Name = "soa", .Ctx = &g_SoA, .Add = SoA_Add_Fn, .Delete = SoA_Delete_Fn, .Advance = SoA_Advance_Fn,
+      .Dispatch = SoA_Dispatch_Fn, .Ticks_To_Next = SoA_Next_Fn, .Tick = SoA_Tick_Fn },
+};
+
+static void Fuzz_Trace(Fuzz_Backend* b, uint32_t tag, uint32_t value) {
+    if (b->TraceLen + 2 <= FUZZ_TRACE_WORDS) {
+        b->Trace[b->TraceLen++] = tag;
+        b->Trace[b->TraceLen++] = value;
+    }
+}
+
+/*----------------------------------------------------------------------------
+ * Operations on one backend (logical task numbers are shared by all)
+ *---------------------------------------------------------------------------*/
+static void Fuzz_Task(void* arg);
+
+static void Fuzz_Do_Add(Fuzz_Backend* b, uint32_t delay, uint32_t period) {
+    uint32_t k = b->NumLogical;
+    uint32_t id;
+
+    if (k == FUZZ_MAX_TASKS) {
+        return;
+    }
+    b->NumLogical++;
+    id = b->Add(b->Ctx, Fuzz_Task, (void*)(uintptr_t)k, delay, period);
+    b->IDs[k] = id;
+    b->Periods[k] = period;
+    b->Live += (id != NO_TASK_ID);
+    Fuzz_Trace(b, 0xA0000000u | k, id != NO_TASK_ID);
+}
+
+static void Fuzz_Do_Delete(Fuzz_Backend* b, uint32_t k) {
+    uint8_t ok = 0;
+
+    if (k < b->NumLogical && b->IDs[k] != NO_TASK_ID) {
+        ok = b->Delete(b->Ctx, b->IDs[k]);
+        if (ok) {
+            b->IDs[k] = NO_TASK_ID;
+            b->Live--;
+        }
+    }
+    Fuzz_Trace(b, 0xD0000000u | k, ok);
+}
+
+static void Fuzz_Task(void* arg) {
+    Fuzz_Backend* b = g_Current;
+    uint32_t k = (uint32_t)(uintptr_t)arg;
+    Fuzz_Action act = g_Actions[k];
+
+    Fuzz_Trace(b, 0xE0000000u | k, b->Tick(b->Ctx));
+    if (b->Periods[k] == 0) {
+        b->Live--;                  // One-shot: gone after this run
+    }
+    if (b->Budget == 0) {
+        return;                     // Stop tasks re-arming each other forever
+    }
+    b->Budget--;
+
+    switch (act.Kind) {
+    case ACT_DELETE:
+        Fuzz_Do_Delete(b, act.Param % (b->NumLogical ? b->NumLogical : 1));
+        break;
+    case ACT_ADD:
+        Fuzz_Do_Add(b, act.Param, 0);
+        break;
+    case ACT_UPDATE:
+        b->Advance(b->Ctx, 1);
+        break;
+    default:
+        break;
+    }
+}
+
+/*----------------------------------------------------------------------------
+ * Cost outliers
+ *---------------------------------------------------------------------------*/
+typedef struct {
+    uint64_t Cost;
+    uint32_t Tasks;
+} Fuzz_Outlier;
+
+typedef struct {
+    uint64_t Count;
+    double Mean;
+    Fuzz_Outlier Worst[FUZZ_OUTLIERS];
+} Fuzz_Cost;
+
+static Fuzz_Cost g_Costs[FUZZ_BACKENDS][OP_COUNT];
+
+static void Fuzz_Cost_Add(Fuzz_Cost* c, uint64_t cost, uint32_t tasks) {
+    c->Count++;
+    c->Mean += ((double)cost - c->Mean) / (double)c->Count;
+
+    if (c->Count < 1000 || cost < FUZZ_OUTLIER_MIN || (double)cost < c->Mean * FUZZ_OUTLIER_FACTOR) {
+        return;
+    }
+    for (int i = 0; i < FUZZ_OUTLIERS; i++) {
+        if (cost > c->Worst[i].Cost) {
+            memmove(&c->Worst[i + 1], &c->Worst[i], (FUZZ_OUTLIERS - 1 - i) * sizeof(Fuzz_Outlier));
+            c->Worst[i].Cost = cost;
+            c->Worst[i].Tasks = tasks;
+            break;
+        }
+    }
+}
+
+static void Fuzz_Report_Costs(void) {
+    fprintf(stderr, "\nper-call cost (%s): mean, then outliers > %dx mean as cost@tasks\n",
+            FUZZ_COST_UNIT, FUZZ_OUTLIER_FACTOR);
+    for (int b = 1; b < FUZZ_BACKENDS; b++) {
+        for (int op = 0; op < OP_COUNT; op++) {
+            const Fuzz_Cost* c = &g_Costs[b][op];
+
+            fprintf(stderr, "  %-5s %-8s %8.0f ", g_BackendTemplates[b].Name, g_OpNames[op], c->Mean);
+            for (int i = 0; i < FUZZ_OUTLIERS && c->Worst[i].Cost > 0; i++) {
+                fprintf(stderr, " %llu@%u", (unsigned long long)c->Worst[i].Cost, (unsigned)c->Worst[i].Tasks);
+            }
+            fprintf(stderr, "\n");
+        }
+    }
+}
+
+/*----------------------------------------------------------------------------
+ * Input decoding and comparison
+ *---------------------------------------------------------------------------*/
+typedef struct {
+    uint8_t Op;
+    uint32_t A;
+    uint32_t B;
+} Fuzz_Call;
+
+typedef struct {
+    const uint8_t* Data;
+    size_t Size;
+    size_t Pos;
+} Fuzz_Input;
+
+static uint32_t Fuzz_Byte(Fuzz_Input* in) {
+    return (in->Pos < in->Size) ? in->Data[in->Pos++] : 0;
+}
+
+/* Mostly short delays (ties), sometimes long ones (deep lists) */
+static uint32_t Fuzz_Delay(Fuzz_Input* in) {
+    uint32_t b = Fuzz_Byte(in);
+
+    if (b < 0xC0) {
+        return b & 0x0F;
+    }
+    return (b & 0x3F) << 16 | Fuzz_Byte(in) << 8 | Fuzz_Byte(in);
+}
+
+static void Fuzz_Print_History(const Fuzz_Call* calls, uint32_t n) {
+    uint32_t first = (n > FUZZ_HISTORY) ? n - FUZZ_HISTORY : 0;
+
+    fprintf(stderr, "last calls:\n");
+    for (uint32_t i = first; i < n; i++) {
+        fprintf(stderr, "  #%u %s %u %u\n", (unsigned)i, g_OpNames[calls[i].Op],
+                (unsigned)calls[i].A, (unsigned)calls[i].B);
+    }
+}
+
+static void Fuzz_Check(const Fuzz_Call* calls, uint32_t n) {
+    const Fuzz_Backend* ref = &g_Backends[0];
+
+    for (int i = 1; i < FUZZ_BACKENDS; i++) {
+        const Fuzz_Backend* b = &g_Backends[i];
+        uint32_t refNext = ref->Ticks_To_Next(ref->Ctx), next = b->Ticks_To_Next(b->Ctx);
+        uint32_t refTick = ref->Tick(ref->Ctx), tick = b->Tick(b->Ctx);
+        uint32_t w = 0;
+
+        while (w < ref->TraceLen && w < b->TraceLen && ref->Trace[w] == b->Trace[w]) {
+            w++;
+        }
+        if (w == ref->TraceLen && w == b->TraceLen && refNext == next && refTick == tick) {
+            continue;
+        }
+
+        fprintf(stderr, "MISMATCH %s vs reference after call #%u\n", b->Name, (unsigned)(n - 1));
+        if (w < ref->TraceLen || w < b->TraceLen) {
+            fprintf(stderr, "  trace word %u: reference %08x, %s %08x\n", (unsigned)w,
+                    w < ref->TraceLen ? ref->Trace[w] : 0, b->Name, w < b->TraceLen ? b->Trace[w] : 0);
+            fprintf(stderr, "  (A|task: add ok, D|task: delete ok, E|task: ran at tick)\n");
+        }
+        fprintf(stderr, "  ticks to next %u vs %u, current tick %u vs %u\n",
+                (unsigned)refNext, (unsigned)next, (unsigned)refTick, (unsigned)tick);
+        Fuzz_Print_History(calls, n);
+        abort();
+    }
+}
+
+static void Fuzz_Reset(void) {
+    memset(&g_Ref, 0, sizeof(g_Ref));
+    g_Ref.NextID = 1;
+    SCH_Ctx_Deinit(&g_List);        // Nodes of the previous input
+    SCH_Ctx_Init(&g_List);
+    SCH_SoA_Init(&g_SoA, g_SoAMem, FUZZ_MAX_TASKS);
+
+    for (int i = 0; i < FUZZ_BACKENDS; i++) {
+        g_Backends[i] = g_BackendTemplates[i];
+    }
+}
+
+static int Fuzz_Run(const uint8_t* data, size_t size) {
+    static Fuzz_Call calls[FUZZ_MAX_OPS];
+    Fuzz_Input in = { data, size, 0 };
+    uint32_t n = 0;
+
+    Fuzz_Reset();
+
+    while (in.Pos < in.Size && n < FUZZ_MAX_OPS) {
+        Fuzz_Call* call = &calls[n++];
+        uint32_t op = Fuzz_Byte(&in) % 10;
+
+        // Weighted: add 3, delete 2, update 2, advance 1, dispatch 2
+        call->Op = (op < 3) ? OP_ADD : (op < 5) ? OP_DELETE : (op < 7) ? OP_UPDATE : (op < 8) ? OP_ADVANCE : OP_DISPATCH;
+        call->A = 0;
+        call->B = 0;
+
+        switch (call->Op) {
+        case OP_ADD: {
+            uint32_t act = Fuzz_Byte(&in);
+
+            call->A = Fuzz_Delay(&in);
+            call->B = (Fuzz_Byte(&in) & 1) ? Fuzz_Delay(&in) : 0;
+            if (g_Backends[0].NumLogical < FUZZ_MAX_TASKS) {
+                // Decided once here, so every backend's task does the same
+                g_Actions[g_Backends[0].NumLogical].Kind = (act < 0xA0) ? ACT_NONE : (uint8_t)(act & 3);
+                g_Actions[g_Backends[0].NumLogical].Param = Fuzz_Byte(&in) & 0x0F;
+            }
+            break;
+        }
+        case OP_DELETE:
+            call->A = Fuzz_Byte(&in) % (g_Backends[0].NumLogical ? g_Backends[0].NumLogical : 1);
+            break;
+        case OP_UPDATE:
+            call->A = 1;
+            break;
+        case OP_ADVANCE:
+            call->A = Fuzz_Byte(&in) << 4;
+            break;
+        default:
+            break;
+        }
+
+        for (int i = 0; i < FUZZ_BACKENDS; i++) {
+            Fuzz_Backend* b = &g_Backends[i];
+            uint32_t tasks = b->Live;
+            uint64_t start;
+
+            b->TraceLen = 0;
+            b->Budget = 64;
+            g_Current = b;
+
+            start = Fuzz_Cycles();
+            switch (call->Op) {
+            case OP_ADD:
+                Fuzz_Do_Add(b, call->A, call->B);
+                break;
+            case OP_DELETE:
+                Fuzz_Do_Delete(b, call->A);
+                break;
+            case OP_UPDATE:
+            case OP_ADVANCE:
+                b->Advance(b->Ctx, call->A);
+                break;
+            default:
+                b->Dispatch(b->Ctx);
+                break;
+            }
+            Fuzz_Cost_Add(&g_Costs[i][call->Op], Fuzz_Cycles() - start, tasks);
+        }
+        g_Current = NULL;
+
+        Fuzz_Check(calls, n);
+    }
+    return 0;
+}
+
+#ifdef SCH_FUZZ_LIBFUZZER
+
+int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
+    static int registered = 0;
+
+    if (!registered) {
+        registered = 1;
+        atexit(Fuzz_Report_Costs);
+    }
+    return Fuzz_Run(data, size);
+}
+
+#else
+
+static int Fuzz_File(const char* path) {
+    static uint8_t buf[1 << 16];
+    FILE* f = (strcmp(path, "-") == 0) ? stdin : fopen(path, "rb");
+    size_t size;
+
+    if (f == NULL) {
+        perror(path);
+        return 2;
+    }
+    size = fread(buf, 1, sizeof(buf), f);
+    if (f != stdin) {
+        fclose(f);
+    }
+    return Fuzz_Run(buf, size);
+}
+
+int main(int argc, char** argv) {
+    uint64_t iterations = 0, seed = 1;
+    int files = 0;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-r") == 0 && i + 1 < argc) {
+            iterations = strtoull(argv[++i], NULL, 0);
+        } else if (strcmp(argv[i], "-s") == 0 && i + 1 < argc) {
+            seed = strtoull(argv[++i], NULL, 0);
+        } else {
+            files++;
+            if (Fuzz_File(argv[i]) != 0) {
+                return 2;
+            }
+        }
+    }
+    if (files == 0 && iterations == 0) {
+        return Fuzz_File("-");
+    }
+
+    for (uint64_t it = 0; it < iterations; it++) {
+        static uint8_t buf[2048];
+        size_t size = 64 + (size_t)(seed % (sizeof(buf) - 64));
+
+        for (size_t i = 0; i < size; i++) {
+            seed ^= seed << 13;
+            seed ^= seed >> 7;
+            seed ^= seed << 17;
+            buf[i] = (uint8_t)(seed >> 24);
+        }
+        Fuzz_Run(buf, size);
+    }
+    printf("%llu random inputs: all backends agree with the reference\n", (unsigned long long)iterations);
+    Fuzz_Report_Costs();
+    return 0;
+}
+
+#endif // SCH_FUZZ_LIBFUZZER
@@ -0,0 +1,82 @@
+/*
+ * linux_run.c
+ *
+ * Run the firmware task set (Tasks_Register) on Linux in real time with
+ * the timerfd/epoll port. LED changes are logged to stdout; each line
+ * typed on stdin prints the scheduler status.
+ *
+ *   linux_run [-t] [seconds]
+ *
+ *   -t   tickless: sleep straight to the next deadline
+ *
+ * Build from the repository root:
+ *   gcc -O2 -IHost/Inc -ICore/Inc Host/Tools/linux_run.c Host/Src/port_linux.c
+ *       Host/Src/sim.c Host/Src/sim_hal.c Core/Src/scheduler.c Core/Src/Tasks.c
+ *       -o linux_run
+ */
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/epoll.h>
+#include <unistd.h>
+#include "port_linux.h"
+#include "Tasks.h"
+
+static PORT_Linux g_Port;
+
+static void On_Signal(int sig) {
+    (void)sig;
+    PORT_Linux_Stop(&g_Port);
+}
+
+static void Stop_Task(void* arg) {
+    PORT_Linux_Stop((PORT_Linux*)arg);
+}
+
+static void On_Stdin(int fd, uint32_t events, void* arg) {
+    PORT_Linux* port = (PORT_Linux*)arg;
+    char buf[256];
+    ssize_t n = read(fd, buf, sizeof(buf));
+
+    (void)events;
+    if (n <= 0) {
+        PORT_Linux_Unwatch_Fd(port, fd);
+        return;
+    }
+    fprintf(stderr, "tick %u, %llu late ticks, next deadline in %u ticks\n",
+            (unsigned)SCH_Ctx_Get_Current_Tick(PORT_Linux_Context(port)),
+            (unsigned long long)port->Overruns,
+            (unsigned)SCH_Ctx_Get_Ticks_To_Next(PORT_Linux_Context(port)));
+}
+
+int main(int argc, char** argv) {
+    uint8_t tickless = 0;
+    double seconds = 0;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-t") == 0) {
+            tickless = 1;
+        } else {
+            seconds = atof(argv[i]);
+        }
+    }
+
+    if (PORT_Linux_Init(&g_Port, TIMER_TICK_MS, tickless) != 0) {
+        perror("port");
+        return 1;
+    }
+    signal(SIGINT, On_Signal);
+    signal(SIGTERM, On_Signal);
+
+    Tasks_Register(PORT_Linux_Context(&g_Port));
+    if (seconds > 0) {
+        SCH_Ctx_Add_Task_Arg(PORT_Linux_Context(&g_Port), Stop_Task, &g_Port,
+                             (uint32_t)(seconds * 1000 / TIMER_TICK_MS), 0);
+    }
+    PORT_Linux_Watch_Fd(&g_Port, STDIN_FILENO, EPOLLIN, On_Stdin, &g_Port);
+
+    PORT_Linux_Run(&g_Port);
+    PORT_Linux_Close(&g_Port);
+    return 0;
+}
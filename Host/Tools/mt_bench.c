@@ -0,0 +1,99 @@
+/*
+ * mt_bench.c
+ *
+ * Exercise the multi-threaded scheduler variant: CPU-heavy periodic jobs
+ * spread over the workers plus one job far longer than a tick, which
+ * must not delay the timer or the other jobs.
+ *
+ *   mt_bench [-w workers] [-n jobs] [-c job_us] [-p period_ticks] [-s seconds]
+ *
+ * Build from the repository root:
+ *   gcc -O2 -pthread -IHost/Inc -ICore/Inc Host/Tools/mt_bench.c
+ *       Host/Src/scheduler_mt.c Core/Src/scheduler.c -o mt_bench
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "scheduler_mt.h"
+
+#define TICK_MS     10
+
+static uint64_t Now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+/* Burn CPU for the number of microseconds passed in arg */
+static void Spin_Job(void* arg) {
+    uint64_t end = Now_ns() + (uint64_t)(uintptr_t)arg * 1000ull;
+    while (Now_ns() < end) {
+    }
+}
+
+int main(int argc, char** argv) {
+    static SCH_MT mt;
+    uint32_t workers = (uint32_t)sysconf(_SC_NPROCESSORS_ONLN), jobs = 32, cost = 2000, period = 5;
+    double seconds = 3;
+    SCH_MT_Job** handles;
+    SCH_MT_Job* longJob;
+    uint64_t runs = 0, skipped = 0, executed = 0, stolen = 0;
+
+    for (int i = 1; i + 1 < argc; i += 2) {
+        uint32_t v = (uint32_t)strtoul(argv[i + 1], NULL, 0);
+
+        if (strcmp(argv[i], "-w") == 0) {
+            workers = v;
+        } else if (strcmp(argv[i], "-n") == 0) {
+            jobs = v;
+        } else if (strcmp(argv[i], "-c") == 0) {
+            cost = v;
+        } else if (strcmp(argv[i], "-p") == 0) {
+            period = v;
+        } else if (strcmp(argv[i], "-s") == 0) {
+            seconds = atof(argv[i + 1]);
+        }
+    }
+    if (SCH_MT_Init(&mt, workers, TICK_MS) != 0) {
+        fprintf(stderr, "bad worker count\n");
+        return 1;
+    }
+
+    handles = malloc(jobs * sizeof(SCH_MT_Job*));
+    for (uint32_t i = 0; i < jobs; i++) {
+        handles[i] = SCH_MT_Add_Task(&mt, Spin_Job, (void*)(uintptr_t)cost, i % period, period);
+    }
+    longJob = SCH_MT_Add_Task(&mt, Spin_Job, (void*)(uintptr_t)300000, 10, 50);
+
+    SCH_MT_Start(&mt);
+    usleep((useconds_t)(seconds * 1e6));
+
+    for (uint32_t i = 0; i < jobs; i++) {
+        runs += atomic_load(&handles[i]->Runs);
+        skipped += atomic_load(&handles[i]->Skipped);
+    }
+    printf("workers %u, %u jobs x %u us every %u ticks, %.1f s\n", workers, jobs, cost, period, seconds);
+    printf("job runs          %llu of %.0f releases, %llu skipped while busy\n",
+           (unsigned long long)runs, seconds * 1000 / TICK_MS / period * jobs, (unsigned long long)skipped);
+    printf("long job runs     %llu, skipped %llu\n",
+           (unsigned long long)atomic_load(&longJob->Runs), (unsigned long long)atomic_load(&longJob->Skipped));
+
+    for (uint32_t i = 0; i < jobs; i++) {
+        SCH_MT_Delete_Task(&mt, handles[i]);
+    }
+    SCH_MT_Delete_Task(&mt, longJob);
+    free(handles);
+
+    SCH_MT_Stop(&mt);
+    for (uint32_t w = 0; w < workers; w++) {
+        executed += mt.Queues[w].Executed;
+        stolen += mt.Queues[w].Stolen;
+    }
+    printf("executed          %llu, %llu stolen (%.1f%%)\n", (unsigned long long)executed,
+           (unsigned long long)stolen, executed ? 100.0 * (double)stolen / (double)executed : 0.0);
+    printf("timer lag max     %.3f ms, %llu releases dropped\n",
+           mt.MaxTimerLag_ns / 1e6, (unsigned long long)mt.Dropped);
+    return 0;
+}
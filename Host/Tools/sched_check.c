@@ -0,0 +1,335 @@
+/*
+ * sched_check.c
+ *
+ * Regression checks for scheduler corner cases that the timeline and
+ * fuzzer runs do not reach: each check builds a small task set on its own
+ * context, drives it for a few ticks and verifies the outcome. Prints one
+ * line per failed expectation and exits 1 if any check failed.
+ *
+ *   sched_check
+ *
+ * Build from the repository root:
+ *   gcc -O2 -pthread -IHost/Inc -ICore/Inc Host/Tools/sched_check.c
+ *       Host/Src/scheduler_mt.c Core/Src/scheduler.c -o sched_check
+ */
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include "scheduler.h"
+#include "scheduler_mt.h"
+
+static uint32_t g_Failures;
+
+#define CHECK(cond)                                                         \
+    do {                                                                    \
+        if (!(cond)) {                                                      \
+            printf("%s:%d: %s: check failed: %s\n", __FILE__, __LINE__,     \
+                   __func__, #cond);                                        \
+            g_Failures++;                                                   \
+        }                                                                   \
+    } while (0)
+
+static SCH_Context g_Ctx;
+static uint32_t g_Runs[4];
+
+static void Check_Reset(void) {
+    SCH_Ctx_Deinit(&g_Ctx);
+    SCH_Ctx_Init(&g_Ctx);
+    memset(g_Runs, 0, sizeof(g_Runs));
+}
+
+static void Task_0(void) { g_Runs[0]++; }
+static void Task_1(void) { g_Runs[1]++; }
+static void Task_2(void) { g_Runs[2]++; }
+
+/* Dispatch, then advance one tick */
+static void Check_Ticks(uint32_t ticks) {
+    while (ticks-- > 0) {
+        SCH_Ctx_Dispatch_Tasks(&g_Ctx);
+        SCH_Ctx_Update(&g_Ctx);
+    }
+}
+
+/*----------------------------------------------------------------------------
+ * Event flags
+ *---------------------------------------------------------------------------*/
+
+static void Count_Message(const void* msg, uint32_t seq) {
+    (void)msg;
+    (void)seq;
+    g_Runs[3]++;
+}
+
+static const SCH_Subscriber g_CountSubscribers[] = { Count_Message };
+SCH_TOPIC_DEFINE(Topic_Check, uint32_t, 2, g_CountSubscribers);
+
+/*
+ * A waiter that leaves its flags set runs once per dispatch, not forever,
+ * and the work after the due tasks (here a topic) still gets its turn.
+ */
+static void Check_Flags_Non_Clearing(void) {
+    static SCH_Flags group;
+
+    Check_Reset();
+    SCH_Flags_Init(&group);
+    SCH_Ctx_Add_Flags(&g_Ctx, &group);
+    SCH_Ctx_Add_Topic(&g_Ctx, &Topic_Check);
+    CHECK(SCH_Ctx_Add_Flag_Task(&g_Ctx, Task_0, &group, 0x1, SCH_FLAGS_ANY, 0) != NO_TASK_ID);
+
+    SCH_Flags_Set(&group, 0x1);
+    *(uint32_t*)SCH_Topic_Claim(&Topic_Check) = 1;
+    SCH_Topic_Publish(&Topic_Check);
+    SCH_Ctx_Dispatch_Tasks(&g_Ctx);
+    CHECK(g_Runs[0] == 1);
+    CHECK(g_Runs[3] == 1);
+    CHECK(g_Ctx.Dispatching == 0);
+
+    SCH_Ctx_Dispatch_Tasks(&g_Ctx);
+    CHECK(g_Runs[0] == 2);
+
+    SCH_Flags_Clear(&group, 0x1);
+    SCH_Ctx_Dispatch_Tasks(&g_Ctx);
+    CHECK(g_Runs[0] == 2);
+}
+
+/* Flag tasks are released by their flags only, never as a successor */
+static void Check_Flags_Not_Successor(void) {
+    static SCH_Flags group;
+    uint32_t before, waiter;
+
+    Check_Reset();
+    SCH_Flags_Init(&group);
+    SCH_Ctx_Add_Flags(&g_Ctx, &group);
+    before = SCH_Ctx_Add_Task(&g_Ctx, Task_0, 0, 1);
+    waiter = SCH_Ctx_Add_Flag_Task(&g_Ctx, Task_1, &group, 0x1, SCH_FLAGS_CLEAR, 0);
+    CHECK(SCH_Ctx_Add_Dependency(&g_Ctx, before, waiter) == 0);
+    CHECK(SCH_Ctx_Get_Error_Code(&g_Ctx) == ERROR_SCH_TASK_NOT_FOUND);
+
+    SCH_Ctx_Dispatch_Tasks(&g_Ctx);
+    CHECK(g_Runs[0] == 1 && g_Runs[1] == 0);
+    SCH_Flags_Set(&group, 0x1);
+    SCH_Ctx_Update(&g_Ctx);
+    SCH_Ctx_Dispatch_Tasks(&g_Ctx);
+    CHECK(g_Runs[0] == 2 && g_Runs[1] == 1);
+    CHECK(SCH_Ctx_Delete_Task(&g_Ctx, waiter) == 1);
+}
+
+static uint32_t g_Wake[2];
+
+static void Task_Wake(void) {
+    if (g_Runs[0] < 2) {
+        g_Wake[g_Runs[0]] = SCH_Ctx_Get_Wake_Flags(&g_Ctx);
+    }
+    g_Runs[0]++;
+}
+
+/* Flags set in the tick the timeout expires: one run, reporting the flags */
+static void Check_Flags_Timeout_Same_Tick(void) {
+    static SCH_Flags group;
+
+    Check_Reset();
+    SCH_Flags_Init(&group);
+    SCH_Ctx_Add_Flags(&g_Ctx, &group);
+    CHECK(SCH_Ctx_Add_Flag_Task(&g_Ctx, Task_Wake, &group, 0x1, SCH_FLAGS_CLEAR, 3) != NO_TASK_ID);
+
+    Check_Ticks(3);
+    CHECK(g_Runs[0] == 0);
+    SCH_Flags_Set(&group, 0x1);
+    SCH_Ctx_Dispatch_Tasks(&g_Ctx);
+    CHECK(g_Runs[0] == 1);
+    CHECK(g_Wake[0] == 0x1);
+    CHECK(SCH_Flags_Get(&group) == 0);
+}
+
+/*----------------------------------------------------------------------------
+ * Topics
+ *---------------------------------------------------------------------------*/
+
+/* A far-behind topic skips its lost messages at once; the oldest slot is claimable */
+static void Check_Topic_Catch_Up(void) {
+    Check_Reset();
+    SCH_Ctx_Add_Topic(&g_Ctx, &Topic_Check);
+    Topic_Check.Lost = 0;
+
+    for (int i = 0; i < 1000; i++) {
+        SCH_Topic_Publish(&Topic_Check);
+    }
+    SCH_Ctx_Dispatch_Tasks(&g_Ctx);
+    CHECK(g_Runs[3] == 1);
+    CHECK(Topic_Check.Lost == 999);
+    CHECK(Topic_Check.Delivered == Topic_Check.Seq);
+}
+
+/*----------------------------------------------------------------------------
+ * Load shedding
+ *---------------------------------------------------------------------------*/
+
+/* Undelivered topic messages do not make on-time ticks count as late */
+static void Check_Shed_Ignores_Topics(void) {
+    Check_Reset();
+    SCH_Ctx_Add_Topic(&g_Ctx, &Topic_Check);
+    SCH_Ctx_Add_Task(&g_Ctx, Task_0, 10, 10);
+    SCH_Ctx_Set_Overload_Policy(&g_Ctx, 2, 0, 1, SCH_CRIT_HIGH);
+
+    SCH_Topic_Publish(&Topic_Check);
+    for (int i = 0; i < 5; i++) {
+        SCH_Ctx_Update(&g_Ctx);
+    }
+    CHECK(!SCH_Ctx_Is_Overloaded(&g_Ctx));
+
+    // A due head that is not dispatched is late
+    for (int i = 0; i < 7; i++) {
+        SCH_Ctx_Update(&g_Ctx);
+    }
+    CHECK(SCH_Ctx_Is_Overloaded(&g_Ctx));
+}
+
+/*----------------------------------------------------------------------------
+ * Elastic periods
+ *---------------------------------------------------------------------------*/
+
+/* Shrinking the period below the lateness of a pending release */
+static void Check_Elastic_Below_Slack(void) {
+    uint32_t id;
+
+    Check_Reset();
+    id = SCH_Ctx_Add_Task_Slack(&g_Ctx, Task_0, 1, 100, 63);    // Placed 63 ticks late
+    CHECK(SCH_Ctx_Get_Ticks_To_Next(&g_Ctx) == 64);
+    CHECK(SCH_Ctx_Set_Elastic(&g_Ctx, id, 10, 40) == 1);
+
+    Check_Ticks(65);
+    CHECK(g_Runs[0] == 1);
+    CHECK(SCH_Ctx_Get_Ticks_To_Next(&g_Ctx) <= 10);
+    Check_Ticks(20);
+    CHECK(g_Runs[0] >= 2);
+}
+
+/*----------------------------------------------------------------------------
+ * Partitions
+ *---------------------------------------------------------------------------*/
+
+/* Stands in for the tick ISR firing several times during one task run */
+static void Task_Slow(void) {
+    for (int i = 0; i < 5; i++) {
+        SCH_Ctx_Update(&g_Ctx);
+    }
+}
+
+/* A one-shot denied after the frame has ended waits one tick, not 2^32 */
+static void Check_Partition_Defer_Past_Frame(void) {
+    static SCH_Partition part;
+
+    Check_Reset();
+    SCH_Partition_Init(&part, "check", 1);
+    SCH_Ctx_Add_Partition(&g_Ctx, &part);
+    SCH_Ctx_Set_Major_Frame(&g_Ctx, 4);
+    SCH_Ctx_Add_Task(&g_Ctx, Task_Slow, 0, 0);
+    SCH_Ctx_Set_Partition(&g_Ctx, SCH_Ctx_Add_Task(&g_Ctx, Task_0, 0, 0), &part);
+    SCH_Ctx_Set_Partition(&g_Ctx, SCH_Ctx_Add_Task(&g_Ctx, Task_1, 0, 0), &part);
+
+    SCH_Ctx_Dispatch_Tasks(&g_Ctx);
+    CHECK(g_Runs[0] == 1 && g_Runs[1] == 0 && part.Denied == 1);
+    CHECK(SCH_Ctx_Get_Ticks_To_Next(&g_Ctx) == 1);
+
+    Check_Ticks(2);
+    CHECK(g_Runs[1] == 1);
+}
+
+/*----------------------------------------------------------------------------
+ * Task chains
+ *---------------------------------------------------------------------------*/
+
+/*
+ * A fast predecessor completing again does not stand in for a slow one,
+ * and deleting the slow one releases the successor it was holding back.
+ */
+static void Check_Chain_Drop_Predecessor(void) {
+    uint32_t fast, slow, after;
+
+    Check_Reset();
+    fast = SCH_Ctx_Add_Task(&g_Ctx, Task_0, 0, 1);
+    slow = SCH_Ctx_Add_Task(&g_Ctx, Task_1, 100, 0);
+    after = SCH_Ctx_Add_Triggered_Task(&g_Ctx, Task_2);
+    CHECK(SCH_Ctx_Add_Dependency(&g_Ctx, fast, after) == 1);
+    CHECK(SCH_Ctx_Add_Dependency(&g_Ctx, slow, after) == 1);
+
+    Check_Ticks(4);
+    CHECK(g_Runs[0] == 4 && g_Runs[2] == 0);
+
+    CHECK(SCH_Ctx_Delete_Task(&g_Ctx, slow) == 1);
+    SCH_Ctx_Dispatch_Tasks(&g_Ctx);
+    CHECK(g_Runs[0] == 5 && g_Runs[2] == 1);
+
+    SCH_Ctx_Update(&g_Ctx);
+    SCH_Ctx_Dispatch_Tasks(&g_Ctx);
+    CHECK(g_Runs[0] == 6 && g_Runs[2] == 2);
+}
+
+/* The cycle check visits each task once, even on layers of diamonds */
+static void Check_Chain_Diamonds(void) {
+    enum { LAYERS = 40 };
+    uint32_t ids[LAYERS][2];
+    uint32_t timed;
+
+    Check_Reset();
+    for (int i = 0; i < LAYERS; i++) {
+        ids[i][0] = SCH_Ctx_Add_Triggered_Task(&g_Ctx, Task_0);
+        ids[i][1] = SCH_Ctx_Add_Triggered_Task(&g_Ctx, Task_0);
+        for (int k = 0; i > 0 && k < 4; k++) {
+            CHECK(SCH_Ctx_Add_Dependency(&g_Ctx, ids[i - 1][k >> 1], ids[i][k & 1]) == 1);
+        }
+    }
+
+    // 2^40 paths from the first layer: only finishes with visit marks
+    timed = SCH_Ctx_Add_Task(&g_Ctx, Task_1, 0, 1);
+    CHECK(SCH_Ctx_Add_Dependency(&g_Ctx, timed, ids[0][0]) == 1);
+    CHECK(SCH_Ctx_Add_Dependency(&g_Ctx, ids[LAYERS - 1][1], ids[0][1]) == 0);
+    CHECK(SCH_Ctx_Get_Error_Code(&g_Ctx) == ERROR_SCH_DEPENDENCY_CYCLE);
+}
+
+/*----------------------------------------------------------------------------
+ * Multi-threaded variant
+ *---------------------------------------------------------------------------*/
+
+static void Job_Nop(void* arg) {
+    (void)arg;
+}
+
+/* A delete that reaches the timer thread in the same batch as its add */
+static void Check_MT_Add_Then_Delete(void) {
+    static SCH_MT mt;
+    SCH_MT_Job* job;
+
+    CHECK(SCH_MT_Init(&mt, 1, 1) == 0);
+    job = SCH_MT_Add_Task(&mt, Job_Nop, NULL, 0, 1);
+    atomic_fetch_add(&job->Refs, 1);        // Keep it readable after Stop
+    SCH_MT_Delete_Task(&mt, job);
+    CHECK(SCH_MT_Start(&mt) == 0);
+    usleep(20000);
+    SCH_MT_Stop(&mt);
+
+    CHECK(mt.Scheduled == NULL);
+    CHECK(atomic_load(&job->Refs) == 1);
+    SCH_MT_Release_Job(job);
+}
+
+int main(void) {
+    Check_Flags_Non_Clearing();
+    Check_Flags_Not_Successor();
+    Check_Flags_Timeout_Same_Tick();
+    Check_Topic_Catch_Up();
+    Check_Shed_Ignores_Topics();
+    Check_Elastic_Below_Slack();
+    Check_Partition_Defer_Past_Frame();
+    Check_Chain_Drop_Predecessor();
+    Check_Chain_Diamonds();
+    Check_MT_Add_Then_Delete();
+
+    SCH_Ctx_Deinit(&g_Ctx);
+    if (g_Failures > 0) {
+        printf("%u check(s) failed\n", (unsigned)g_Failures);
+        return 1;
+    }
+    printf("all checks passed\n");
+    return 0;
+}
@@ -0,0 +1,263 @@
+/*
+ * sched_explore.c
+ *
+ * Monte Carlo schedulability explorer. Runs a task set through the real
+ * scheduler.c many times with sampled execution times (and optionally
+ * random phasing) and reports response time percentiles, peak per-tick
+ * load and the probability of a deadline miss.
+ *
+ *   sched_explore [-f file]... [-g tasks -u util] [-n trials] [-s seconds]
+ *                 [-j threads] [-r seed] [-o]
+ *
+ *   -f   task set file, may be given several times (e.g. the existing set
+ *        plus the tasks of a new feature). One task per line:
+ *            name period_ticks offset_ticks dist a_us [b_us]
+ *        dist is fixed, uniform (a..b), normal (mean a, sd b) or
+ *        bimodal (a, b with 1% probability). '#' starts a comment.
+ *   -g   generate a random set of this many tasks at utilization -u
+ *   -o   randomize task offsets in every trial
+ *
+ * Build from the repository root:
+ *   gcc -O2 -pthread -IHost/Inc -ICore/Inc Host/Tools/sched_explore.c
+ *       Host/Src/sim_timing.c Host/Src/sim_pool.c Host/Src/sim_stats.c
+ *       Core/Src/scheduler.c -lm -o sched_explore
+ */
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "sim_pool.h"
+#include "sim_timing.h"
+
+#define MAX_TASKS       64
+
+typedef struct {
+    SIM_Hist Response[MAX_TASKS];
+    uint64_t Jobs[MAX_TASKS];
+    uint64_t Misses[MAX_TASKS];
+    SIM_Hist PeakLoad;              // Peak tick load per trial, us
+    uint64_t FailedTrials;          // Trials with at least one miss
+    uint64_t LostTicks;
+} Worker_Stats;
+
+typedef struct {
+    SIM_TaskSpec Specs[MAX_TASKS];
+    char Names[MAX_TASKS][32];
+    uint32_t NumTasks;
+    uint32_t Ticks;
+    uint64_t Seed;
+    int RandomOffsets;
+    Worker_Stats* Stats;
+} Explorer;
+
+static int Explorer_Load(Explorer* ex, const char* path) {
+    static const char* kinds[] = { "fixed", "uniform", "normal", "bimodal" };
+    char line[256], name[32], kind[16];
+    unsigned period, offset, a, b;
+    FILE* f = fopen(path, "r");
+    int lineNo = 0;
+
+    if (f == NULL) {
+        perror(path);
+        return -1;
+    }
+    while (fgets(line, sizeof(line), f) != NULL) {
+        char* hash = strchr(line, '#');
+        SIM_TaskSpec* spec = &ex->Specs[ex->NumTasks];
+        int n;
+
+        lineNo++;
+        if (hash != NULL) {
+            *hash = '\0';
+        }
+        b = 0;
+        n = sscanf(line, "%31s %u %u %15s %u %u", name, &period, &offset, kind, &a, &b);
+        if (n <= 0) {
+            continue;
+        }
+        if (n < 5 || period == 0 || ex->NumTasks == MAX_TASKS) {
+            fprintf(stderr, "%s:%d: bad task line\n", path, lineNo);
+            fclose(f);
+            return -1;
+        }
+        spec->ExecKind = 0xFF;
+        for (uint8_t k = 0; k < 4; k++) {
+            if (strcmp(kind, kinds[k]) == 0) {
+                spec->ExecKind = k;
+            }
+        }
+        if (spec->ExecKind == 0xFF) {
+            fprintf(stderr, "%s:%d: unknown distribution '%s'\n", path, lineNo, kind);
+            fclose(f);
+            return -1;
+        }
+        spec->Period = period;
+        spec->Offset = offset;
+        spec->ExecA = a;
+        spec->ExecB = b;
+        strcpy(ex->Names[ex->NumTasks++], name);
+    }
+    fclose(f);
+    return 0;
+}
+
+/* UUniFast utilization split over harmonic-ish periods */
+static void Explorer_Generate(Explorer* ex, uint32_t count, double util) {
+    static const uint32_t periods[] = { 1, 2, 5, 10, 20, 50, 100 };
+    uint64_t rng = ex->Seed;
+    double left = util;
+
+    for (uint32_t i = 0; i < count && ex->NumTasks < MAX_TASKS; i++) {
+        SIM_TaskSpec* spec = &ex->Specs[ex->NumTasks];
+        double share = left;
+        double mean;
+
+        if (i + 1 < count) {
+            double next = left * pow(SIM_Rand_Unit(&rng), 1.0 / (count - i - 1));
+            share = left - next;
+            left = next;
+        }
+        spec->Period = periods[SIM_Rand(&rng) % (sizeof(periods) / sizeof(periods[0]))];
+        spec->Offset = (uint32_t)(SIM_Rand(&rng) % spec->Period);
+        mean = share * spec->Period * SIM_TICK_US;
+        spec->ExecKind = SIM_EXEC_UNIFORM;
+        spec->ExecA = (uint32_t)(mean * 0.8);
+        spec->ExecB = (uint32_t)(mean * 1.2);
+        snprintf(ex->Names[ex->NumTasks++], 32, "gen%u", i);
+    }
+}
+
+static void Explorer_Trial(uint32_t trial, uint32_t worker, void* user) {
+    Explorer* ex = (Explorer*)user;
+    Worker_Stats* st = &ex->Stats[worker];
+    SIM_TaskSpec specs[MAX_TASKS];
+    SIM_TimingTask tasks[MAX_TASKS];
+    SIM_Device dev;
+    uint64_t rng = ex->Seed ^ ((uint64_t)(trial + 1) * 0x2545F4914F6CDD1Dull);
+    int failed = 0;
+
+    memcpy(specs, ex->Specs, sizeof(SIM_TaskSpec) * ex->NumTasks);
+    if (ex->RandomOffsets) {
+        for (uint32_t i = 0; i < ex->NumTasks; i++) {
+            specs[i].Offset = (uint32_t)(SIM_Rand(&rng) % specs[i].Period);
+        }
+    }
+
+    SIM_Device_Init(&dev, specs, tasks, ex->NumTasks, rng);
+    for (uint32_t i = 0; i < ex->NumTasks; i++) {
+        tasks[i].Response = &st->Response[i];
+    }
+    SIM_Device_Run(&dev, ex->Ticks);
+
+    for (uint32_t i = 0; i < ex->NumTasks; i++) {
+        st->Jobs[i] += tasks[i].Jobs;
+        st->Misses[i] += tasks[i].Misses;
+        failed |= tasks[i].Misses > 0;
+    }
+    SIM_Hist_Add(&st->PeakLoad, dev.PeakTickBusy);
+    st->FailedTrials += (uint64_t)failed;
+    st->LostTicks += dev.LostTicks;
+
+    SIM_Device_Free(&dev);
+}
+
+int main(int argc, char** argv) {
+    static Explorer ex;
+    uint32_t trials = 1000, threads = 0, generate = 0;
+    double seconds = 60, util = 0.5;
+    Worker_Stats* total;
+    uint64_t misses = 0;
+
+    ex.Seed = 1;
+    for (int i = 1; i < argc; i++) {
+        const char* arg = (i + 1 < argc) ? argv[i + 1] : NULL;
+
+        if (strcmp(argv[i], "-o") == 0) {
+            ex.RandomOffsets = 1;
+            continue;
+        }
+        if (arg == NULL) {
+            goto usage;
+        }
+        if (strcmp(argv[i], "-f") == 0) {
+            if (Explorer_Load(&ex, arg) != 0) {
+                return 1;
+            }
+        } else if (strcmp(argv[i], "-g") == 0) {
+            generate = (uint32_t)strtoul(arg, NULL, 0);
+        } else if (strcmp(argv[i], "-u") == 0) {
+            util = atof(arg);
+        } else if (strcmp(argv[i], "-n") == 0) {
+            trials = (uint32_t)strtoul(arg, NULL, 0);
+        } else if (strcmp(argv[i], "-s") == 0) {
+            seconds = atof(arg);
+        } else if (strcmp(argv[i], "-j") == 0) {
+            threads = (uint32_t)strtoul(arg, NULL, 0);
+        } else if (strcmp(argv[i], "-r") == 0) {
+            ex.Seed = strtoull(arg, NULL, 0);
+        } else {
+            goto usage;
+        }
+        i++;
+    }
+    if (generate > 0) {
+        Explorer_Generate(&ex, generate, util);
+    }
+    if (ex.NumTasks == 0) {
+        goto usage;
+    }
+    if (threads == 0) {
+        threads = SIM_Pool_Default_Threads();
+    }
+
+    ex.Ticks = (uint32_t)(seconds * 1000000 / SIM_TICK_US);
+    ex.Stats = calloc(threads, sizeof(Worker_Stats));
+    total = calloc(1, sizeof(Worker_Stats));
+
+    SIM_Pool_Run(trials, threads, Explorer_Trial, &ex);
+
+    for (uint32_t w = 0; w < threads; w++) {
+        Worker_Stats* st = &ex.Stats[w];
+
+        for (uint32_t i = 0; i < ex.NumTasks; i++) {
+            SIM_Hist_Merge(&total->Response[i], &st->Response[i]);
+            total->Jobs[i] += st->Jobs[i];
+            total->Misses[i] += st->Misses[i];
+        }
+        SIM_Hist_Merge(&total->PeakLoad, &st->PeakLoad);
+        total->FailedTrials += st->FailedTrials;
+        total->LostTicks += st->LostTicks;
+    }
+
+    printf("%u trials x %.0f s, %u tasks\n\n", trials, seconds, ex.NumTasks);
+    printf("%-16s %7s %7s %9s %9s %9s %9s %10s\n",
+           "task", "period", "offset", "p50 us", "p99 us", "p99.9 us", "worst us", "miss/job");
+    for (uint32_t i = 0; i < ex.NumTasks; i++) {
+        const SIM_Hist* h = &total->Response[i];
+
+        printf("%-16s %7u %7u %9u %9u %9u %9u %10.2e\n", ex.Names[i],
+               ex.Specs[i].Period, ex.Specs[i].Offset,
+               SIM_Hist_Percentile(h, 50), SIM_Hist_Percentile(h, 99),
+               SIM_Hist_Percentile(h, 99.9), h->Max,
+               total->Jobs[i] ? (double)total->Misses[i] / (double)total->Jobs[i] : 0.0);
+        misses += total->Misses[i];
+    }
+    printf("\npeak tick load     p50 %.1f%%  p99 %.1f%%  worst %.1f%%\n",
+           100.0 * SIM_Hist_Percentile(&total->PeakLoad, 50) / SIM_TICK_US,
+           100.0 * SIM_Hist_Percentile(&total->PeakLoad, 99) / SIM_TICK_US,
+           100.0 * total->PeakLoad.Max / SIM_TICK_US);
+    printf("lost ticks         %.2f per trial\n", (double)total->LostTicks / trials);
+    printf("overrun prob.      %.4f (%llu of %u trials missed a deadline)\n",
+           (double)total->FailedTrials / trials, (unsigned long long)total->FailedTrials, trials);
+    printf("verdict            %s\n", misses == 0 && total->PeakLoad.Max < SIM_TICK_US ?
+           "fits" : "does NOT fit");
+
+    free(total);
+    free(ex.Stats);
+    return misses == 0 ? 0 : 3;
+
+usage:
+    fprintf(stderr, "usage: %s [-f file]... [-g tasks -u util] [-n trials] [-s seconds]"
+            " [-j threads] [-r seed] [-o]\n", argv[0]);
+    return 2;
+}
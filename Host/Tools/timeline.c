@@ -0,0 +1,128 @@
+/*
+ * timeline.c
+ *
+ * Golden timeline regression check for the firmware task set
+ * (Tasks_Register). Records every GPIO transition and the GPIO work of
+ * each dispatch in host simulation and compares it with a stored run.
+ *
+ *   timeline record [-t] [-n ticks] file   write a new golden timeline
+ *   timeline check [-t] [-w window] [-m lines] golden
+ *                                          rerun and diff, exit 1 on change
+ *   timeline dump file                     print a timeline as text
+ *
+ *   -t   tick-by-tick instead of fast-forward
+ *   -n   ticks to simulate (default 6000 = 60 s, two hyperperiods)
+ *   -w   edges up to this many ticks apart count as drift (default 10)
+ *   -m   detail lines printed per category (default 20)
+ *
+ * The golden timeline of the LED tasks is Host/Golden/led_tasks.tl.
+ * Re-record it only for intended timing changes.
+ *
+ * Build from the repository root:
+ *   gcc -O2 -IHost/Inc -ICore/Inc Host/Tools/timeline.c Host/Src/sim_timeline.c
+ *       Host/Src/sim.c Host/Src/sim_hal.c Core/Src/scheduler.c Core/Src/Tasks.c -o timeline
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "sim_timeline.h"
+#include "Tasks.h"
+
+static void Record(SIM_Timeline* tl, uint32_t ticks, uint8_t mode) {
+    SIM_Sim sim;
+
+    SIM_Init(&sim);
+    Tasks_Register(&sim.Sched);
+    SIM_TL_Init(tl);
+    SIM_TL_Record(tl, &sim, ticks, mode);
+}
+
+static void Dump(const SIM_Timeline* tl) {
+    printf("# %u ticks, %u events\n", (unsigned)tl->Ticks, (unsigned)tl->Count);
+    for (uint32_t i = 0; i < tl->Count; i++) {
+        const SIM_TL_Event* ev = &tl->Events[i];
+
+        if (ev->Kind == SIM_TL_EDGE) {
+            printf("%u edge P%c %04x %04x\n", (unsigned)ev->Tick, 'A' + ev->Port, ev->Changed, (unsigned)ev->Value);
+        } else {
+            printf("%u work %u\n", (unsigned)ev->Tick, (unsigned)ev->Value);
+        }
+    }
+}
+
+static int Usage(void) {
+    fprintf(stderr, "usage: timeline record [-t] [-n ticks] file\n"
+                    "       timeline check [-t] [-w window] [-m lines] golden\n"
+                    "       timeline dump file\n");
+    return 2;
+}
+
+int main(int argc, char** argv) {
+    SIM_TL_Options opt = { 10, 20 };
+    SIM_Timeline golden, now;
+    SIM_TL_Result res;
+    uint8_t mode = SIM_FAST_FORWARD;
+    uint32_t ticks = 6000;
+    const char* cmd;
+    const char* path = NULL;
+
+    if (argc < 3) {
+        return Usage();
+    }
+    cmd = argv[1];
+    for (int i = 2; i < argc; i++) {
+        if (strcmp(argv[i], "-t") == 0) {
+            mode = SIM_TICK_BY_TICK;
+        } else if (strcmp(argv[i], "-n") == 0 && i + 1 < argc) {
+            ticks = (uint32_t)strtoul(argv[++i], NULL, 0);
+        } else if (strcmp(argv[i], "-w") == 0 && i + 1 < argc) {
+            opt.DriftWindow = (uint32_t)strtoul(argv[++i], NULL, 0);
+        } else if (strcmp(argv[i], "-m") == 0 && i + 1 < argc) {
+            opt.MaxReports = (uint32_t)strtoul(argv[++i], NULL, 0);
+        } else {
+            path = argv[i];
+        }
+    }
+    if (path == NULL) {
+        return Usage();
+    }
+
+    if (strcmp(cmd, "record") == 0) {
+        Record(&now, ticks, mode);
+        if (SIM_TL_Save(&now, path) != 0) {
+            perror(path);
+            return 2;
+        }
+        printf("recorded %u ticks, %u events to %s\n", (unsigned)now.Ticks, (unsigned)now.Count, path);
+        SIM_TL_Free(&now);
+        return 0;
+    }
+
+    if (SIM_TL_Load(&golden, path) != 0) {
+        fprintf(stderr, "%s: cannot read timeline\n", path);
+        return 2;
+    }
+    if (strcmp(cmd, "dump") == 0) {
+        Dump(&golden);
+        SIM_TL_Free(&golden);
+        return 0;
+    }
+    if (strcmp(cmd, "check") != 0) {
+        return Usage();
+    }
+
+    Record(&now, golden.Ticks, mode);
+    SIM_TL_Diff(&golden, &now, &opt, &res, stdout);
+    printf("%u ticks: %u edges drifted (max %+d), %u missing, %u extra, %u ticks with changed work\n",
+           (unsigned)golden.Ticks, (unsigned)res.Drifted, (int)res.MaxDrift, (unsigned)res.Missing,
+           (unsigned)res.Extra, (unsigned)res.WorkChanged);
+    SIM_TL_Free(&golden);
+    SIM_TL_Free(&now);
+
+    if (res.Drifted || res.Missing || res.Extra || res.WorkChanged) {
+        printf("FAIL: timeline differs from golden\n");
+        return 1;
+    }
+    printf("OK\n");
+    return 0;
+}